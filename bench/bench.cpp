@@ -0,0 +1,194 @@
+#include <new>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include <harness.hpp>
+
+#include <ranges.hpp>
+#include <operations.hpp>
+#include <derivate.hpp>
+#include <minimize_1d.hpp>
+
+void* operator new(std::size_t size){
+    bench::allocations()++;
+    if(void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+};
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+};
+
+void operator delete(void* p, std::size_t) noexcept{
+    std::free(p);
+};
+
+namespace{
+    using vec = std::vector<double>;
+
+    struct quadratic{
+        template<typename Range>
+        double operator()(const Range& r) const{
+            double ret_val = 0.;
+            for(std::size_t i = 0; i < r.size(); i++){
+                const double x = r.at(i);
+                ret_val += static_cast<double>(i + 1) * x * x;
+            };
+            return ret_val;
+        };
+    };
+
+    struct counted_1d{
+        mutable std::size_t calls = 0;
+        double operator()(const double x) const{
+            calls++;
+            return (x - 1.) * (x - 1.) + std::cosh(x - 1.);
+        };
+    };
+
+    vec filled(const std::size_t n, const double scale){
+        vec ret_val(n);
+        for(std::size_t i = 0; i < n; i++) ret_val[i] = scale * std::sin(static_cast<double>(i));
+        return ret_val;
+    };
+
+    void add_range_cases(bench::registry& reg){
+        using namespace minimize::ranges;
+        for(const std::size_t n : {4, 64, 1024, 16384}){
+            const std::string dim = "/" + std::to_string(n);
+            reg.add("raw_sum" + dim, [n](const std::size_t it){
+                const vec a = filled(n, 1.), b = filled(n, 2.);
+                vec out(n);
+                for(std::size_t k = 0; k < it; k++){
+                    for(std::size_t i = 0; i < n; i++) out[i] = a[i] + b[i];
+                    bench::do_not_optimize(out.data()[k % n]);
+                };
+            });
+            reg.add("ops_sum" + dim, [n](const std::size_t it){
+                const vec a = filled(n, 1.), b = filled(n, 2.);
+                vec out(n);
+                for(std::size_t k = 0; k < it; k++){
+                    ops::assign(out, ops::sum(const_range(a), const_range(b)));
+                    bench::do_not_optimize(out.data()[k % n]);
+                };
+            });
+            reg.add("raw_mul" + dim, [n](const std::size_t it){
+                const vec a = filled(n, 1.), b = filled(n, 2.);
+                vec out(n);
+                for(std::size_t k = 0; k < it; k++){
+                    for(std::size_t i = 0; i < n; i++) out[i] = a[i] * b[i];
+                    bench::do_not_optimize(out.data()[k % n]);
+                };
+            });
+            reg.add("ops_mul" + dim, [n](const std::size_t it){
+                const vec a = filled(n, 1.), b = filled(n, 2.);
+                vec out(n);
+                for(std::size_t k = 0; k < it; k++){
+                    ops::assign(out, ops::mul(const_range(a), const_range(b)));
+                    bench::do_not_optimize(out.data()[k % n]);
+                };
+            });
+            reg.add("ops_at_sum" + dim, [n](const std::size_t it){
+                const vec a = filled(n, 1.), b = filled(n, 2.);
+                for(std::size_t k = 0; k < it; k++){
+                    const auto s = ops::sum(const_range(a), const_range(b));
+                    double acc = 0.;
+                    for(std::size_t i = 0; i < n; i++) acc += s.at(i);
+                    bench::do_not_optimize(acc);
+                };
+            });
+            reg.add("bop_axpy" + dim, [n](const std::size_t it){
+                const vec x = filled(n, 1.), d = filled(n, 2.);
+                vec out(n);
+                for(std::size_t k = 0; k < it; k++){
+                    ops::assign(out, ops::sum(const_range(x), ops::scalar_mul(0.5, const_range(d))));
+                    bench::do_not_optimize(out.data()[k % n]);
+                };
+            });
+            reg.add("affine_axpy" + dim, [n](const std::size_t it){
+                const vec x = filled(n, 1.), d = filled(n, 2.);
+                vec out(n);
+                for(std::size_t k = 0; k < it; k++){
+                    ops::assign(out, ops::axpy(x, 0.5, d));
+                    bench::do_not_optimize(out.data()[k % n]);
+                };
+            });
+        };
+    };
+
+    void add_derivative_cases(bench::registry& reg){
+        using namespace minimize;
+        for(const std::size_t n : {2, 8, 32}){
+            const std::string dim = "/" + std::to_string(n);
+            reg.add("auto_grad" + dim, [n](const std::size_t it){
+                const quadratic f;
+                const vec x = filled(n, 1.);
+                for(std::size_t k = 0; k < it; k++){
+                    const auto g = derivate::auto_grad(f, ranges::const_range(x));
+                    bench::do_not_optimize(g.data()[0]);
+                };
+            });
+            reg.add("derive_by_direction" + dim, [n](const std::size_t it){
+                const quadratic f;
+                const vec x = filled(n, 1.), d = filled(n, 0.5);
+                for(std::size_t k = 0; k < it; k++){
+                    const double g = derivate::derive_by_direction(f,
+                        ranges::const_range(x), ranges::const_range(d));
+                    bench::do_not_optimize(g);
+                };
+            });
+        };
+    };
+
+    void add_golden_cases(bench::registry& reg){
+        const std::pair<const char*, double> tolerances[] = {{"1e-4", 1.e-4}, {"1e-8", 1.e-8}, {"1e-12", 1.e-12}};
+        for(const auto& t : tolerances){
+            const double tol = t.second;
+            const counted_1d f;
+            const auto res = minimize::D1::golden_ratio_minimize(f, {-10., 10.}, tol, 4096);
+            reg.record(std::string("golden_evaluations/tol=") + t.first, {
+                {"evaluations", static_cast<double>(f.calls)},
+                {"error", std::abs(res.second - 1.)}
+            });
+        };
+        reg.add("golden_ratio_minimize/1e-8", [](const std::size_t it){
+            const counted_1d f;
+            for(std::size_t k = 0; k < it; k++){
+                const auto res = minimize::D1::golden_ratio_minimize(f, {-10., 10.}, 1.e-8, 4096);
+                bench::do_not_optimize(res.second);
+            };
+        });
+    };
+};
+
+// bench [--json path] [--filter substring] [--min-time seconds]
+int main(int argc, char** argv){
+    std::string json, filter;
+    bench::registry reg;
+    for(int i = 1; i + 1 < argc; i += 2){
+        const std::string key(argv[i]);
+        if(key == "--json") json = argv[i + 1];
+        else if(key == "--filter") filter = argv[i + 1];
+        else if(key == "--min-time") reg.min_time(std::atof(argv[i + 1]));
+        else{
+            std::cerr << "Unknown option " << key << std::endl;
+            return 1;
+        };
+    };
+    add_range_cases(reg);
+    add_derivative_cases(reg);
+    add_golden_cases(reg);
+    reg.run(filter);
+    if(json.empty()){
+        reg.write_json(std::cout);
+    }else{
+        std::ofstream out(json);
+        reg.write_json(out);
+    };
+    return 0;
+};
@@ -0,0 +1,109 @@
+#ifndef BENCH_HARNESS
+#define BENCH_HARNESS
+
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <ostream>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace bench{
+    // Global allocation counter; the benchmark binary feeds it from its
+    // replacement of the global operator new
+    inline std::atomic<std::size_t>& allocations(void){
+        static std::atomic<std::size_t> count{0};
+        return count;
+    };
+
+    template<typename T>
+    inline void do_not_optimize(const T& value){
+        asm volatile("" : : "r,m"(value) : "memory");
+    };
+
+    struct result{
+        std::string name;
+        std::size_t iterations;
+        double ns_per_op, allocs_per_op;
+        // Extra named counters, e.g. objective evaluations
+        std::vector<std::pair<std::string, double> > counters;
+    };
+
+    class registry{
+        protected:
+            using body = std::function<void(std::size_t)>;
+            std::vector<std::pair<std::string, body> > _cases;
+            std::vector<result> _results;
+            double _min_time = 0.05;
+        public:
+            void min_time(const double seconds){
+                _min_time = seconds;
+            };
+            // fn(iterations) runs the measured operation iterations times;
+            // its setup is measured by fn(0) and left out of the results
+            void add(const std::string& name, body fn){
+                _cases.emplace_back(name, std::move(fn));
+            };
+            // Counters reported without timing
+            void record(const std::string& name,
+                    std::vector<std::pair<std::string, double> > counters){
+                _results.push_back({name, 0, 0., 0., std::move(counters)});
+            };
+            void run(const std::string& filter){
+                using clock = std::chrono::steady_clock;
+                for(const auto& c : _cases){
+                    if(c.first.find(filter) == std::string::npos) continue;
+                    c.second(1);
+                    // Setup cost: the fastest of a few empty runs
+                    double setup_time = 0.;
+                    std::size_t setup_allocs = 0;
+                    for(int k = 0; k < 3; k++){
+                        const std::size_t a0 = allocations().load();
+                        const auto t0 = clock::now();
+                        c.second(0);
+                        const double elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+                        setup_allocs = allocations().load() - a0;
+                        setup_time = (k == 0) ? elapsed : std::min(setup_time, elapsed);
+                    };
+                    std::size_t iterations = 1;
+                    while(true){
+                        const std::size_t a0 = allocations().load();
+                        const auto t0 = clock::now();
+                        c.second(iterations);
+                        const double total = std::chrono::duration<double>(clock::now() - t0).count();
+                        const double elapsed = std::max(total - setup_time, 0.);
+                        const std::size_t used = allocations().load() - a0,
+                                          allocs = (used > setup_allocs) ? used - setup_allocs : 0;
+                        if((elapsed >= _min_time) || (iterations >= (std::size_t(1) << 30))){
+                            const double it = static_cast<double>(iterations);
+                            _results.push_back({c.first, iterations, 1.e9 * elapsed / it,
+                                static_cast<double>(allocs) / it, {}});
+                            break;
+                        };
+                        iterations *= (elapsed < 0.1 * _min_time) ? 10 : 2;
+                    };
+                };
+            };
+            void write_json(std::ostream& out) const{
+                out << "{\n  \"benchmarks\": [";
+                for(std::size_t i = 0; i < _results.size(); i++){
+                    const result& r = _results[i];
+                    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\"";
+                    if(r.iterations > 0)
+                        out << ", \"iterations\": " << r.iterations
+                            << ", \"ns_per_op\": " << r.ns_per_op
+                            << ", \"allocs_per_op\": " << r.allocs_per_op;
+                    for(const auto& c : r.counters)
+                        out << ", \"" << c.first << "\": " << c.second;
+                    out << "}";
+                };
+                out << "\n  ]\n}\n";
+            };
+    };
+};
+
+#endif
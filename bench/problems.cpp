@@ -0,0 +1,149 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+#include <problems.hpp>
+#include <grad_minimize.hpp>
+#include <nelder_mead.hpp>
+#include <trust_region.hpp>
+#include <least_squares.hpp>
+#include <box_minimize.hpp>
+#include <coordinate_descent.hpp>
+#include <cmaes.hpp>
+#include <differential_evolution.hpp>
+#include <multistart.hpp>
+
+namespace{
+    using namespace minimize;
+    using vec = std::vector<double>;
+
+    struct row{
+        std::string problem;
+        std::size_t dim;
+        std::string solver;
+        bool status;
+        std::size_t evaluations;
+        double seconds, value, f_error, x_error;
+    };
+
+    template<typename Problem, typename = void>
+    struct has_residuals : std::false_type{};
+
+    template<typename Problem>
+    struct has_residuals<Problem, std::void_t<decltype(std::declval<const Problem&>().residual_count())> >
+        : std::true_type{};
+
+    // Runs one solver on a fresh counter; solvers above max_dim are skipped
+    template<typename Problem, typename Solver>
+    void measure(std::vector<row>& rows, const Problem& p, const std::string& solver,
+            const std::size_t max_dim, const Solver& solve){
+        if(p.dim() > max_dim) return;
+        const problems::counted<Problem> f(p);
+        const auto t0 = std::chrono::steady_clock::now();
+        const grad::min_result_nd res = solve(f);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        const double value = p(ranges::const_range(res.x));
+        rows.push_back({p.name(), p.dim(), solver, res.status, f.calls(), seconds,
+            value, std::abs(value - p.optimum()), problems::solution_error(p, res.x)});
+        std::cerr << p.name() << "/" << p.dim() << " " << solver << ": " << f.calls()
+                  << " evaluations, " << seconds << " s" << std::endl;
+    };
+
+    template<typename Problem>
+    void run_all(std::vector<row>& rows, const Problem& p){
+        const vec x0 = p.start();
+        const box::bounds b = p.bounds();
+        measure(rows, p, "steepest_descent", 200, [&](const auto& f){
+            return grad::steepest_descent(f, x0);
+        });
+        measure(rows, p, "bfgs", 1000, [&](const auto& f){
+            return grad::bfgs_minimize(f, x0);
+        });
+        measure(rows, p, "nelder_mead", 20, [&](const auto& f){
+            return nelder_mead::minimize(f, x0);
+        });
+        measure(rows, p, "trust_region_newton", 50, [&](const auto& f){
+            return trust_region::newton_minimize(f, x0);
+        });
+        measure(rows, p, "coordinate_descent", 20, [&](const auto& f){
+            return coordinate::minimize(f, x0);
+        });
+        measure(rows, p, "box_quasi_newton", 1000, [&](const auto& f){
+            return box::minimize(f, x0, b);
+        });
+        measure(rows, p, "cmaes", 20, [&](const auto& f){
+            return cmaes::minimize(f, x0);
+        });
+        measure(rows, p, "differential_evolution", 20, [&](const auto& f){
+            return differential_evolution::minimize(f, b);
+        });
+        measure(rows, p, "multistart_bfgs", 10, [&](const auto& f){
+            multistart::params mp;
+            mp.count = 16;
+            mp.threads = 1;
+            return multistart::minimize(f, b, mp).best;
+        });
+        if constexpr(has_residuals<Problem>::value){
+            measure(rows, p, "levenberg_marquardt", 1000, [&](const auto& f){
+                return least_squares::lm_minimize(f, p.residual_count(), x0);
+            });
+        };
+    };
+
+    void write_csv(std::ostream& out, const std::vector<row>& rows){
+        out << "problem,dim,solver,status,evaluations,seconds,value,f_error,x_error\n";
+        out.precision(10);
+        for(const row& r : rows)
+            out << r.problem << "," << r.dim << "," << r.solver << "," << r.status << ","
+                << r.evaluations << "," << r.seconds << "," << r.value << ","
+                << r.f_error << "," << r.x_error << "\n";
+    };
+
+    void write_json(std::ostream& out, const std::vector<row>& rows){
+        out.precision(10);
+        out << "{\n  \"runs\": [";
+        for(std::size_t i = 0; i < rows.size(); i++){
+            const row& r = rows[i];
+            out << (i ? ",\n" : "\n")
+                << "    {\"problem\": \"" << r.problem << "\", \"dim\": " << r.dim
+                << ", \"solver\": \"" << r.solver << "\", \"status\": " << (r.status ? "true" : "false")
+                << ", \"evaluations\": " << r.evaluations << ", \"seconds\": " << r.seconds
+                << ", \"value\": " << r.value << ", \"f_error\": " << r.f_error
+                << ", \"x_error\": " << r.x_error << "}";
+        };
+        out << "\n  ]\n}\n";
+    };
+};
+
+// problems [--csv path] [--json path] [--large n]
+// Without an output path the CSV table goes to stdout
+int main(int argc, char** argv){
+    std::string csv, json;
+    std::size_t large = 200;
+    for(int i = 1; i + 1 < argc; i += 2){
+        const std::string key(argv[i]);
+        if(key == "--csv") csv = argv[i + 1];
+        else if(key == "--json") json = argv[i + 1];
+        else if(key == "--large") large = std::strtoul(argv[i + 1], nullptr, 10);
+        else{
+            std::cerr << "Unknown option " << key << std::endl;
+            return 1;
+        };
+    };
+    std::vector<row> rows;
+    problems::suite([&rows](const auto& p){ run_all(rows, p); }, large);
+    if(csv.empty() && json.empty()) write_csv(std::cout, rows);
+    if(!csv.empty()){
+        std::ofstream out(csv);
+        write_csv(out, rows);
+    };
+    if(!json.empty()){
+        std::ofstream out(json);
+        write_json(out, rows);
+    };
+    return 0;
+};
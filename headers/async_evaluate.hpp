@@ -0,0 +1,451 @@
+#ifndef ASYNC_EVALUATE
+#define ASYNC_EVALUATE
+
+#if !defined(__cpp_impl_coroutine)
+#error "async_evaluate.hpp requires C++20 coroutines"
+#endif
+
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <coroutine>
+#include <condition_variable>
+
+#include <cmath>
+#include <utility>
+#include <exception>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <evaluate.hpp>
+#include <nelder_mead.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace async{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        // Lazily started coroutine; awaiting it runs the body and resumes
+        // the awaiter by symmetric transfer once the body returns
+        template<typename T>
+        class task{
+            public:
+                struct promise_type;
+                using handle = std::coroutine_handle<promise_type>;
+                struct final_awaiter{
+                    bool await_ready(void) const noexcept{
+                        return false;
+                    };
+                    std::coroutine_handle<> await_suspend(handle h) const noexcept{
+                        return h.promise().continuation;
+                    };
+                    void await_resume(void) const noexcept{};
+                };
+                struct promise_type{
+                    std::optional<T> value;
+                    std::exception_ptr error;
+                    std::coroutine_handle<> continuation = std::noop_coroutine();
+                    task get_return_object(void){
+                        return task(handle::from_promise(*this));
+                    };
+                    std::suspend_always initial_suspend(void) const noexcept{
+                        return {};
+                    };
+                    final_awaiter final_suspend(void) const noexcept{
+                        return {};
+                    };
+                    void return_value(T v){
+                        value.emplace(std::move(v));
+                    };
+                    void unhandled_exception(void){
+                        error = std::current_exception();
+                    };
+                };
+            protected:
+                handle _handle;
+                explicit task(handle h):
+                    _handle(h)
+                    {};
+            public:
+                task(task&& other) noexcept:
+                    _handle(std::exchange(other._handle, nullptr))
+                    {};
+                task(const task&) = delete;
+                task& operator=(const task&) = delete;
+                ~task(){
+                    if(_handle) _handle.destroy();
+                };
+                bool await_ready(void) const noexcept{
+                    return false;
+                };
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter){
+                    _handle.promise().continuation = awaiter;
+                    return _handle;
+                };
+                T await_resume(void){
+                    auto& pr = _handle.promise();
+                    if(pr.error) std::rethrow_exception(pr.error);
+                    return std::move(*pr.value);
+                };
+        };
+
+        // Result of an evaluation already submitted elsewhere; complete()
+        // or fail() may come from any thread and resumes the awaiter there
+        template<typename T>
+        class pending{
+            protected:
+                struct shared{
+                    std::mutex lock;
+                    bool ready = false;
+                    T value{};
+                    std::exception_ptr error;
+                    std::coroutine_handle<> waiter;
+                };
+                std::shared_ptr<shared> _state;
+                void finish(void) const{
+                    std::coroutine_handle<> w;
+                    {
+                        std::lock_guard<std::mutex> guard(_state->lock);
+                        _state->ready = true;
+                        w = std::exchange(_state->waiter, nullptr);
+                    };
+                    if(w) w.resume();
+                };
+            public:
+                pending(void):
+                    _state(std::make_shared<shared>())
+                    {};
+                void complete(T v) const{
+                    {
+                        std::lock_guard<std::mutex> guard(_state->lock);
+                        _state->value = std::move(v);
+                    };
+                    finish();
+                };
+                void fail(std::exception_ptr e) const{
+                    {
+                        std::lock_guard<std::mutex> guard(_state->lock);
+                        _state->error = e;
+                    };
+                    finish();
+                };
+                bool await_ready(void) const{
+                    std::lock_guard<std::mutex> guard(_state->lock);
+                    return _state->ready;
+                };
+                bool await_suspend(std::coroutine_handle<> h) const{
+                    std::lock_guard<std::mutex> guard(_state->lock);
+                    if(_state->ready) return false;
+                    _state->waiter = h;
+                    return true;
+                };
+                T await_resume(void) const{
+                    std::lock_guard<std::mutex> guard(_state->lock);
+                    if(_state->error) std::rethrow_exception(_state->error);
+                    return _state->value;
+                };
+        };
+
+        namespace detail{
+            struct detached{
+                struct promise_type{
+                    detached get_return_object(void) const noexcept{
+                        return {};
+                    };
+                    std::suspend_never initial_suspend(void) const noexcept{
+                        return {};
+                    };
+                    std::suspend_never final_suspend(void) const noexcept{
+                        return {};
+                    };
+                    void return_void(void) const noexcept{};
+                    void unhandled_exception(void) const noexcept{
+                        std::terminate();
+                    };
+                };
+            };
+
+            template<typename T>
+            struct waiter{
+                std::mutex lock;
+                std::condition_variable cv;
+                bool done = false;
+                std::optional<T> value;
+                std::exception_ptr error;
+            };
+
+            template<typename T>
+            detached run(task<T>& t, waiter<T>& w){
+                try{
+                    w.value.emplace(co_await t);
+                }catch(...){
+                    w.error = std::current_exception();
+                };
+                std::lock_guard<std::mutex> guard(w.lock);
+                w.done = true;
+                w.cv.notify_all();
+            };
+        };
+
+        // Blocks the calling thread until t finishes on whichever thread
+        // completes its last evaluation
+        template<typename T>
+        T sync_wait(task<T> t){
+            detail::waiter<T> w;
+            detail::run(t, w);
+            std::unique_lock<std::mutex> guard(w.lock);
+            w.cv.wait(guard, [&w]{ return w.done; });
+            if(w.error) std::rethrow_exception(w.error);
+            return std::move(*w.value);
+        };
+
+        // Local stand-in for an external solver: f(x) queues a copy of x
+        // and returns a pending<rv>; workers evaluate func after latency
+        template<typename Func>
+        class threaded_objective{
+            protected:
+                struct request{
+                    vec x;
+                    pending<rv> result;
+                };
+                const Func& _func;
+                const std::chrono::microseconds _latency;
+                mutable std::mutex _lock;
+                mutable std::condition_variable _cv;
+                mutable std::deque<request> _queue;
+                bool _stop = false;
+                std::vector<std::thread> _workers;
+                void work(void){
+                    while(true){
+                        std::unique_lock<std::mutex> guard(_lock);
+                        _cv.wait(guard, [this]{ return _stop || !_queue.empty(); });
+                        if(_queue.empty()) return;
+                        request req(std::move(_queue.front()));
+                        _queue.pop_front();
+                        guard.unlock();
+                        if(_latency.count() > 0) std::this_thread::sleep_for(_latency);
+                        try{
+                            req.result.complete(_func(ranges::const_range(req.x)));
+                        }catch(...){
+                            req.result.fail(std::current_exception());
+                        };
+                    };
+                };
+            public:
+                threaded_objective(const Func& func, const std::size_t workers,
+                        const std::chrono::microseconds latency = std::chrono::microseconds(0)):
+                    _func(func), _latency(latency)
+                    {
+                        for(std::size_t t = 0; t < std::max<std::size_t>(workers, 1); t++)
+                            _workers.emplace_back([this]{ work(); });
+                    };
+                threaded_objective(const threaded_objective&) = delete;
+                threaded_objective& operator=(const threaded_objective&) = delete;
+                ~threaded_objective(){
+                    {
+                        std::lock_guard<std::mutex> guard(_lock);
+                        _stop = true;
+                    };
+                    _cv.notify_all();
+                    for(auto& w : _workers) w.join();
+                };
+                pending<rv> operator()(const vec& x) const{
+                    request req{x, pending<rv>()};
+                    const pending<rv> ret_val = req.result;
+                    {
+                        std::lock_guard<std::mutex> guard(_lock);
+                        _queue.push_back(std::move(req));
+                    };
+                    _cv.notify_one();
+                    return ret_val;
+                };
+        };
+
+        // Async objectives are called as f(x) with a vec they must copy and
+        // return an awaitable yielding rv; evaluation starts on the call
+        template<typename AsyncFunc>
+        using awaitable_t = decltype(std::declval<const AsyncFunc&>()(std::declval<const vec&>()));
+
+        // Issues one evaluation per row of points before awaiting any
+        template<typename AsyncFunc>
+        task<std::size_t> evaluate_batch(const AsyncFunc& f, const vec& points,
+                const std::size_t n, vec& values){
+            if(points.size() != values.size() * n)
+                throw std::length_error("Points should hold one row per value");
+            std::vector<awaitable_t<AsyncFunc> > inflight;
+            inflight.reserve(values.size());
+            vec x(n);
+            for(std::size_t i = 0; i < values.size(); i++){
+                std::copy(points.cbegin() + i * n, points.cbegin() + (i + 1) * n, x.begin());
+                inflight.push_back(f(x));
+            };
+            for(std::size_t i = 0; i < values.size(); i++) values[i] = co_await inflight[i];
+            co_return values.size();
+        };
+
+        // Four-point gradient with all 4n evaluations in flight at once
+        template<typename AsyncFunc>
+        task<vec> auto_grad(const AsyncFunc& f, const vec& x, const rv h = 1.e-8){
+            vec points, values(4 * x.size()), ret_val(x.size());
+            evaluate::gradient_stencil(x, h, points);
+            co_await evaluate_batch(f, points, x.size(), values);
+            evaluate::gradient_from_stencil(values, h, ret_val);
+            co_return ret_val;
+        };
+
+        // Batched evaluator (see evaluate.hpp) over an async objective, so
+        // population methods submit a whole generation at once
+        template<typename AsyncFunc>
+        class blocking_evaluator{
+            protected:
+                const AsyncFunc& _func;
+            public:
+                explicit blocking_evaluator(const AsyncFunc& func):
+                    _func(func)
+                    {};
+                void operator()(const vec& points, const std::size_t n, vec& values) const{
+                    sync_wait(evaluate_batch(_func, points, n, values));
+                };
+        };
+
+        // Nelder-Mead whose shrink steps are evaluated concurrently; with
+        // speculative set, reflection, expansion and both contractions of a
+        // step are submitted together so a step costs one round trip
+        template<typename AsyncFunc>
+        task<grad::min_result_nd> nelder_mead_minimize(const AsyncFunc& f, const vec& x0,
+                const nelder_mead::params p = {}, const bool speculative = true){
+            const std::size_t n = x0.size();
+            const nelder_mead::coefficients k = nelder_mead::make_coefficients(n, p.adaptive);
+            nelder_mead::simplex s(x0, p);
+            const auto vertex = [&s, n](const std::size_t v){
+                return vec(s.vertex(v), s.vertex(v) + n);
+            };
+            const auto shrink = [&](const std::size_t b) -> task<std::size_t>{
+                const auto bt = s.vertex(b);
+                std::vector<awaitable_t<AsyncFunc> > inflight;
+                inflight.reserve(n);
+                for(std::size_t v = 0; v <= n; v++){
+                    if(v == b) continue;
+                    const auto it = s.vertex(v);
+                    for(std::size_t i = 0; i < n; i++) it[i] = bt[i] + k.shrink * (it[i] - bt[i]);
+                    inflight.push_back(f(vertex(v)));
+                };
+                for(std::size_t j = 0; j < n; j++){
+                    const std::size_t v = (j < b) ? j : j + 1;
+                    s.value(v) = co_await inflight[j];
+                };
+                s.update_sum();
+                co_return n;
+            };
+            {
+                vec values(n + 1);
+                std::vector<awaitable_t<AsyncFunc> > inflight;
+                inflight.reserve(n + 1);
+                for(std::size_t v = 0; v <= n; v++) inflight.push_back(f(vertex(v)));
+                for(std::size_t v = 0; v <= n; v++) s.value(v) = co_await inflight[v];
+            };
+            vec c(n), xw(n), xr(n), xe(n), xo(n), xi(n);
+            for(std::size_t step = 0; step < p.max_steps; step++){
+                const nelder_mead::order o = nelder_mead::find_order(s);
+                if((s.value(o.worst) - s.value(o.best) <= p.ftol) && (s.spread(o.best) <= p.xtol))
+                    co_return grad::min_result_nd{true, vertex(o.best), s.value(o.best), step};
+                s.centroid(o.worst, c);
+                xw = vertex(o.worst);
+                nelder_mead::affine(c, - k.reflection, xw, xr);
+                nelder_mead::affine(c, k.expansion, xr, xe);
+                nelder_mead::affine(c, k.contraction, xr, xo);
+                nelder_mead::affine(c, k.contraction, xw, xi);
+                std::optional<awaitable_t<AsyncFunc> > ae, ao, ai;
+                if(speculative){
+                    ae.emplace(f(xe));
+                    ao.emplace(f(xo));
+                    ai.emplace(f(xi));
+                };
+                const rv fr = co_await f(xr);
+                if(fr < s.value(o.best)){
+                    const rv fe = ae ? co_await *ae : co_await f(xe);
+                    if(fe < fr) s.replace(o.worst, xe, fe);
+                    else s.replace(o.worst, xr, fr);
+                }else if(fr < s.value(o.second)){
+                    s.replace(o.worst, xr, fr);
+                }else if(fr < s.value(o.worst)){
+                    const rv fc = ao ? co_await *ao : co_await f(xo);
+                    if(fc <= fr) s.replace(o.worst, xo, fc);
+                    else co_await shrink(o.best);
+                }else{
+                    const rv fc = ai ? co_await *ai : co_await f(xi);
+                    if(fc < s.value(o.worst)) s.replace(o.worst, xi, fc);
+                    else co_await shrink(o.best);
+                };
+            };
+            const nelder_mead::order o = nelder_mead::find_order(s);
+            co_return grad::min_result_nd{false, vertex(o.best), s.value(o.best), p.max_steps};
+        };
+
+        // BFGS on the concurrent gradient; each line search round submits
+        // trials alpha, alpha / 2, ... together and takes the first
+        // (largest) one satisfying the Armijo condition
+        template<typename AsyncFunc>
+        task<grad::min_result_nd> bfgs_minimize(const AsyncFunc& f, const vec& x0,
+                const grad::params p = {}, const std::size_t trials = 4){
+            const std::size_t n = x0.size(), m = std::max<std::size_t>(trials, 1);
+            vec x(x0), xn(n), d(n), s(n), y(n), h(n * n, 0.);
+            vec points(m * n), values(m);
+            for(std::size_t i = 0; i < n; i++) h[i * n + i] = 1.;
+            rv value = co_await f(x);
+            vec g = co_await auto_grad(f, x, p.h);
+            for(std::size_t step = 0; step < p.max_steps; step++){
+                if(grad::norm(g) < p.tol) co_return grad::min_result_nd{true, x, value, step};
+                for(std::size_t i = 0; i < n; i++){
+                    d[i] = 0.;
+                    for(std::size_t j = 0; j < n; j++) d[i] -= h[i * n + j] * g[j];
+                };
+                rv slope = grad::dot(g, d);
+                if(!(slope < 0.)){
+                    std::fill(h.begin(), h.end(), 0.);
+                    for(std::size_t i = 0; i < n; i++){
+                        h[i * n + i] = 1.;
+                        d[i] = - g[i];
+                    };
+                    slope = grad::dot(g, d);
+                };
+                rv alpha = 1., found = 0., fn = value;
+                for(std::size_t round = 0; (round < p.wolfe.max_steps) && (found == 0.); round++){
+                    for(std::size_t t = 0; t < m; t++){
+                        const rv a = alpha / std::pow(2., static_cast<rv>(t));
+                        for(std::size_t i = 0; i < n; i++) points[t * n + i] = x[i] + a * d[i];
+                    };
+                    co_await evaluate_batch(f, points, n, values);
+                    for(std::size_t t = 0; t < m; t++){
+                        const rv a = alpha / std::pow(2., static_cast<rv>(t));
+                        if(values[t] <= value + p.wolfe.c1 * a * slope){
+                            found = a;
+                            fn = values[t];
+                            break;
+                        };
+                    };
+                    alpha /= std::pow(2., static_cast<rv>(m));
+                };
+                if(found == 0.) co_return grad::min_result_nd{false, x, value, step};
+                for(std::size_t i = 0; i < n; i++){
+                    xn[i] = x[i] + found * d[i];
+                    s[i] = xn[i] - x[i];
+                };
+                const vec gn = co_await auto_grad(f, xn, p.h);
+                for(std::size_t i = 0; i < n; i++) y[i] = gn[i] - g[i];
+                grad::bfgs_update(h, s, y);
+                x.swap(xn);
+                g = gn;
+                value = fn;
+            };
+            co_return grad::min_result_nd{false, x, value, p.max_steps};
+        };
+    };
+};
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef BATCH
+#define BATCH
+
+#include <array>
+#include <vector>
+
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <exception>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <parallel.hpp>
+#include <line_search.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace batch{
+        using rv = double;
+        using vec = std::vector<double>;
+        template<std::size_t N>
+        using point = std::array<rv, N>;
+
+        constexpr std::size_t max_dim = 16;
+
+        struct instance_result{
+            bool status = false;
+            rv value = 0.;
+            std::size_t steps = 0;
+        };
+
+        namespace fixed{
+            template<std::size_t N>
+            rv dot(const point<N>& a, const point<N>& b){
+                rv ret_val = 0.;
+                for(std::size_t i = 0; i < N; i++) ret_val += a[i] * b[i];
+                return ret_val;
+            };
+
+            template<std::size_t N, typename Func>
+            void gradient(const Func& f, const point<N>& x, const rv h, point<N>& g){
+                const auto xr = ranges::const_range(x);
+                for(std::size_t i = 0; i < N; i++) g[i] = derivate::derive_by_axis(f, xr, i, h);
+            };
+
+            // BFGS with the whole state on the stack; the compile-time
+            // dimension lets the compiler unroll and vectorize the n-loops
+            template<std::size_t N, typename Func>
+            instance_result bfgs_minimize(const Func& f, point<N>& x, const grad::params& p = {}){
+                point<N> g, gn, d, s, y, hy, trial;
+                std::array<rv, N * N> h{};
+                for(std::size_t i = 0; i < N; i++) h[i * N + i] = 1.;
+                rv value = f(ranges::const_range(x));
+                gradient(f, x, p.h, g);
+                const auto phi = [&](const rv alpha){
+                    for(std::size_t i = 0; i < N; i++) trial[i] = x[i] + alpha * d[i];
+                    const auto tr = ranges::const_range(trial), dr = ranges::const_range(d);
+                    return std::make_pair(f(tr), derivate::derive_by_direction(f, tr, dr, p.h));
+                };
+                for(std::size_t step = 0; step < p.max_steps; step++){
+                    const rv gnorm = std::sqrt(dot(g, g));
+                    if(gnorm < p.tol) return {true, value, step};
+                    for(std::size_t i = 0; i < N; i++){
+                        d[i] = 0.;
+                        for(std::size_t j = 0; j < N; j++) d[i] -= h[i * N + j] * g[j];
+                    };
+                    rv slope = dot(g, d);
+                    if(!(slope < 0.)){
+                        h.fill(0.);
+                        for(std::size_t i = 0; i < N; i++){
+                            h[i * N + i] = 1.;
+                            d[i] = - g[i];
+                        };
+                        slope = dot(g, d);
+                    };
+                    const rv alpha = (step == 0) ? std::min(1., 1. / gnorm) : 1.;
+                    const auto ls = line_search::wolfe_search(phi, value, slope, alpha, p.wolfe);
+                    if(!(ls.second.alpha > 0.)) return {false, value, step};
+                    for(std::size_t i = 0; i < N; i++) trial[i] = x[i] + ls.second.alpha * d[i];
+                    gradient(f, trial, p.h, gn);
+                    for(std::size_t i = 0; i < N; i++){
+                        s[i] = trial[i] - x[i];
+                        y[i] = gn[i] - g[i];
+                    };
+                    const rv sy = dot(s, y);
+                    if(sy > 0.){
+                        if(step == 0){
+                            const rv scale = sy / dot(y, y);
+                            for(std::size_t i = 0; i < N; i++) h[i * N + i] = scale;
+                        };
+                        for(std::size_t i = 0; i < N; i++){
+                            hy[i] = 0.;
+                            for(std::size_t j = 0; j < N; j++) hy[i] += h[i * N + j] * y[j];
+                        };
+                        const rv a = (sy + dot(y, hy)) / (sy * sy);
+                        for(std::size_t i = 0; i < N; i++)
+                            for(std::size_t j = 0; j < N; j++)
+                                h[i * N + j] += a * s[i] * s[j] - (hy[i] * s[j] + s[i] * hy[j]) / sy;
+                    };
+                    x = trial;
+                    g = gn;
+                    value = ls.second.value;
+                };
+                return {std::sqrt(dot(g, g)) < p.tol, value, p.max_steps};
+            };
+        };
+
+        // Instance i starts from starts[i * N, (i + 1) * N) and minimizes
+        // f(x, prms[i]); its optimum is written to xs[i * N, (i + 1) * N)
+        template<std::size_t N, typename Func, typename Param>
+        void minimize(const Func& f, const vec& starts, const std::vector<Param>& prms,
+                vec& xs, std::vector<instance_result>& results,
+                const grad::params& p = {},
+                const std::size_t threads = parallel::hardware_threads()){
+            const std::size_t count = prms.size();
+            if((starts.size() != count * N) || (xs.size() != count * N) || (results.size() != count))
+                throw std::length_error("Batch buffers should match instance count");
+            parallel::parallel_for_dynamic(count, threads, [&](const std::size_t i, const std::size_t){
+                const Param& prm = prms[i];
+                const auto fi = [&](const auto& r){ return f(r, prm); };
+                point<N> x;
+                std::copy(starts.cbegin() + i * N, starts.cbegin() + (i + 1) * N, x.begin());
+                results[i] = fixed::bfgs_minimize<N>(fi, x, p);
+                std::copy(x.cbegin(), x.cend(), xs.begin() + i * N);
+            });
+        };
+
+        // Runtime dimension dispatched onto the fixed paths 1, ..., max_dim
+        template<std::size_t N = 1, typename Func, typename Param>
+        void minimize_dynamic(const std::size_t n, const Func& f, const vec& starts,
+                const std::vector<Param>& prms, vec& xs,
+                std::vector<instance_result>& results,
+                const grad::params& p = {},
+                const std::size_t threads = parallel::hardware_threads()){
+            if constexpr(N > max_dim){
+                throw std::length_error("Batch dimension exceeds batch::max_dim");
+            }else{
+                if(n == N) minimize<N>(f, starts, prms, xs, results, p, threads);
+                else minimize_dynamic<N + 1>(n, f, starts, prms, xs, results, p, threads);
+            };
+        };
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef BOX_MINIMIZE
+#define BOX_MINIMIZE
+
+#include <vector>
+
+#include <cmath>
+#include <utility>
+#include <exception>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <operations.hpp>
+#include <derivate.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace box{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        struct bounds{
+            vec lower, upper;
+            std::size_t dim(void) const{
+                return lower.size();
+            };
+            template<typename Range>
+            auto project(const Range& r) const{
+                return ranges::ops::clamp(r, lower, upper);
+            };
+        };
+
+        struct params{
+            rv tol = 1.e-6;
+            std::size_t max_steps = 1024;
+            rv h = 1.e-8;
+            rv c1 = 1.e-4;
+            rv backtrack = 0.5;
+            std::size_t max_backtracks = 48;
+        };
+
+        // Four-point central stencil inside the box, second order one-sided
+        // stencils next to a bound; no shifted point leaves [lower, upper]
+        template<typename Func>
+        rv derive_by_axis(const Func& f, const vec& x, const rv value,
+                const bounds& b, const std::size_t i, const rv h){
+            const auto xr = ranges::const_range(x);
+            const rv lo = b.lower[i] - x[i], hi = b.upper[i] - x[i];
+            if((lo <= -2. * h) && (hi >= 2. * h))
+                return derivate::derive_by_axis(f, xr, i, h);
+            const rv s = (hi >= 2. * h) ? h : ((lo <= -2. * h) ? -h :
+                0.5 * ((hi >= -lo) ? hi : lo));
+            if(s == 0.) return 0.;
+            const rv f1 = f(derivate::shifted_x(xr, i, s)),
+                     f2 = f(derivate::shifted_x(xr, i, 2. * s));
+            return (- 3. * value + 4. * f1 - f2) / (2. * s);
+        };
+
+        template<typename Func>
+        vec gradient(const Func& f, const vec& x, const rv value,
+                const bounds& b, const rv h){
+            if constexpr(derivate::has_value_and_gradient<Func>::value)
+                return grad::gradient(f, x, h);
+            vec ret_val(x.size());
+            for(std::size_t i = 0; i < x.size(); i++)
+                ret_val[i] = derive_by_axis(f, x, value, b, i, h);
+            return ret_val;
+        };
+
+        // A variable is active when it sits on a bound and the gradient
+        // pushes it outwards
+        inline bool update_active(const vec& x, const vec& g, const bounds& b,
+                std::vector<bool>& active){
+            bool changed = false;
+            for(std::size_t i = 0; i < x.size(); i++){
+                const bool a = ((x[i] <= b.lower[i]) && (g[i] > 0.))
+                            || ((x[i] >= b.upper[i]) && (g[i] < 0.));
+                changed = changed || (a != active[i]);
+                active[i] = a;
+            };
+            return changed;
+        };
+
+        inline rv projected_gradient_norm(const vec& x, const vec& g, const bounds& b){
+            rv ret_val = 0.;
+            for(std::size_t i = 0; i < x.size(); i++){
+                const rv px = std::min(std::max(x[i] - g[i], b.lower[i]), b.upper[i]);
+                ret_val = std::max(ret_val, std::abs(px - x[i]));
+            };
+            return ret_val;
+        };
+
+        inline void reset(vec& h, const std::size_t n){
+            std::fill(h.begin(), h.end(), 0.);
+            for(std::size_t i = 0; i < n; i++) h[i * n + i] = 1.;
+        };
+
+        // Projected quasi-Newton: BFGS on the free variables, Armijo
+        // backtracking along the projection arc P(x + alpha d)
+        template<typename Func>
+        grad::min_result_nd minimize(const Func& f, const vec& x0,
+                const bounds& b, const params& p = {}){
+            const std::size_t n = x0.size();
+            if((b.lower.size() != n) || (b.upper.size() != n))
+                throw std::length_error("Bounds should have same length with x0");
+            for(std::size_t i = 0; i < n; i++)
+                if(b.lower[i] > b.upper[i])
+                    throw std::logic_error("Lower bound exceeds upper bound");
+            vec x(n), xt(n), d(n), s(n), y(n), h(n * n);
+            const auto px0 = b.project(x0);
+            for(std::size_t i = 0; i < n; i++) x[i] = px0.at(i);
+            rv value = f(ranges::const_range(x));
+            vec g = gradient(f, x, value, b, p.h);
+            std::vector<bool> active(n, false);
+            reset(h, n);
+            for(std::size_t step = 0; step < p.max_steps; step++){
+                if(projected_gradient_norm(x, g, b) < p.tol) return {true, x, value, step};
+                if(update_active(x, g, b, active)) reset(h, n);
+                for(std::size_t i = 0; i < n; i++){
+                    d[i] = 0.;
+                    if(active[i]) continue;
+                    for(std::size_t j = 0; j < n; j++)
+                        if(!active[j]) d[i] -= h[i * n + j] * g[j];
+                };
+                if(!(grad::dot(g, d) < 0.)){
+                    reset(h, n);
+                    for(std::size_t i = 0; i < n; i++) d[i] = active[i] ? 0. : - g[i];
+                };
+                rv alpha = (step == 0) ? std::min(1., 1. / grad::norm(g)) : 1., vt = value;
+                bool accepted = false;
+                for(std::size_t bt = 0; (bt < p.max_backtracks) && !accepted; bt++, alpha *= p.backtrack){
+                    const auto trial = b.project(derivate::shifted_by_direction(x, d, alpha));
+                    vt = f(trial);
+                    for(std::size_t i = 0; i < n; i++) xt[i] = trial.at(i);
+                    rv decrease = 0.;
+                    for(std::size_t i = 0; i < n; i++) decrease += g[i] * (xt[i] - x[i]);
+                    accepted = (decrease < 0.) && (vt <= value + p.c1 * decrease);
+                };
+                if(!accepted) return {false, x, value, step};
+                vec gn = gradient(f, xt, vt, b, p.h);
+                for(std::size_t i = 0; i < n; i++){
+                    s[i] = xt[i] - x[i];
+                    y[i] = gn[i] - g[i];
+                };
+                grad::bfgs_update(h, s, y);
+                std::swap(x, xt);
+                g = std::move(gn);
+                value = vt;
+            };
+            return {projected_gradient_norm(x, g, b) < p.tol, x, value, p.max_steps};
+        };
+    };
+};
+
+#endif
\ No newline at end of file
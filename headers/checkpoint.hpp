@@ -0,0 +1,278 @@
+#ifndef CHECKPOINT
+#define CHECKPOINT
+
+#include <new>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <minimize_1d.hpp>
+#include <nelder_mead.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace checkpoint{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        enum class kind : std::uint32_t{
+            golden = 1,
+            bfgs = 2,
+            nelder_mead = 3
+        };
+
+        namespace detail{
+            constexpr std::uint64_t magic = 0x544e494f504b4843ull;
+            constexpr std::uint32_t version = 1;
+
+            struct file_header{
+                std::uint64_t magic;
+                std::uint32_t version, kind;
+                std::uint64_t capacity;
+                // Committed generation; the live slot is generation % 2
+                std::atomic<std::uint64_t> generation;
+            };
+
+            struct slot_header{
+                std::uint64_t step, size;
+            };
+
+            constexpr std::size_t header_bytes = 64;
+            static_assert(sizeof(file_header) <= header_bytes, "Header outgrew its line");
+            static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                "Generation counter should be lock-free to live in a shared mapping");
+        };
+
+        // Fixed-layout state file: a header and two slots of capacity
+        // doubles. stage() exposes the idle slot and commit() publishes it
+        // by bumping the generation, so a crash mid-write leaves the last
+        // committed state intact. flush() forces the pages to disk.
+        class mapped_file{
+            protected:
+                int _fd;
+                std::size_t _capacity, _bytes;
+                void* _memory;
+                detail::file_header* header(void) const{
+                    return static_cast<detail::file_header*>(_memory);
+                };
+                std::size_t slot_bytes(void) const{
+                    return sizeof(detail::slot_header) + _capacity * sizeof(rv);
+                };
+                detail::slot_header* slot(const std::uint64_t generation) const{
+                    return reinterpret_cast<detail::slot_header*>(static_cast<char*>(_memory)
+                        + detail::header_bytes + (generation % 2) * slot_bytes());
+                };
+            public:
+                mapped_file(const std::string& path, const kind k, const std::size_t capacity):
+                    _fd(open(path.c_str(), O_RDWR | O_CREAT, 0644)),
+                    _capacity(capacity),
+                    _bytes(detail::header_bytes + 2 * (sizeof(detail::slot_header) + capacity * sizeof(rv))),
+                    _memory(MAP_FAILED)
+                    {
+                        if(_fd < 0) throw std::runtime_error("Cannot open checkpoint " + path);
+                        struct stat st;
+                        if(fstat(_fd, &st) != 0){
+                            close(_fd);
+                            throw std::runtime_error("Cannot stat checkpoint " + path);
+                        };
+                        const bool fresh = (st.st_size == 0);
+                        if(fresh && (ftruncate(_fd, static_cast<off_t>(_bytes)) != 0)){
+                            close(_fd);
+                            throw std::runtime_error("Cannot size checkpoint " + path);
+                        };
+                        if(!fresh && (static_cast<std::size_t>(st.st_size) != _bytes)){
+                            close(_fd);
+                            throw std::logic_error("Checkpoint " + path + " has another layout");
+                        };
+                        _memory = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+                        if(_memory == MAP_FAILED){
+                            close(_fd);
+                            throw std::runtime_error("Cannot map checkpoint " + path);
+                        };
+                        detail::file_header* h = header();
+                        if(fresh){
+                            h->magic = detail::magic;
+                            h->version = detail::version;
+                            h->kind = static_cast<std::uint32_t>(k);
+                            h->capacity = capacity;
+                            new(&h->generation) std::atomic<std::uint64_t>(0);
+                        }else if((h->magic != detail::magic) || (h->version != detail::version)
+                                || (h->kind != static_cast<std::uint32_t>(k)) || (h->capacity != capacity)){
+                            munmap(_memory, _bytes);
+                            close(_fd);
+                            throw std::logic_error("Checkpoint " + path + " has another layout");
+                        };
+                    };
+                mapped_file(const mapped_file&) = delete;
+                mapped_file& operator=(const mapped_file&) = delete;
+                ~mapped_file(){
+                    munmap(_memory, _bytes);
+                    close(_fd);
+                };
+                std::size_t capacity(void) const{
+                    return _capacity;
+                };
+                bool empty(void) const{
+                    return header()->generation.load(std::memory_order_acquire) == 0;
+                };
+                std::uint64_t step(void) const{
+                    return slot(header()->generation.load(std::memory_order_acquire))->step;
+                };
+                std::size_t size(void) const{
+                    return slot(header()->generation.load(std::memory_order_acquire))->size;
+                };
+                const rv* state(void) const{
+                    return reinterpret_cast<const rv*>(
+                        slot(header()->generation.load(std::memory_order_acquire)) + 1);
+                };
+                rv* stage(void){
+                    return reinterpret_cast<rv*>(
+                        slot(header()->generation.load(std::memory_order_relaxed) + 1) + 1);
+                };
+                void commit(const std::uint64_t step, const std::size_t size){
+                    const std::uint64_t next = header()->generation.load(std::memory_order_relaxed) + 1;
+                    detail::slot_header* s = slot(next);
+                    s->step = step;
+                    s->size = size;
+                    header()->generation.store(next, std::memory_order_release);
+                };
+                void flush(void) const{
+                    msync(_memory, _bytes, MS_SYNC);
+                };
+                void clear(void){
+                    header()->generation.store(0, std::memory_order_release);
+                };
+        };
+
+        // Payload layouts
+        constexpr std::size_t golden_size = 7;
+
+        inline std::size_t bfgs_size(const std::size_t n){
+            return 1 + 2 * n + n * n;
+        };
+
+        inline std::size_t nelder_mead_size(const std::size_t n){
+            return (n + 1) * (n + 1) + n;
+        };
+
+        inline void require(const mapped_file& file, const std::size_t size){
+            if(file.capacity() < size)
+                throw std::length_error("Checkpoint slots are too small for this state");
+        };
+
+        // The committed payload should be the one this run would write
+        inline void expect(const mapped_file& file, const std::size_t size){
+            if(file.size() != size)
+                throw std::logic_error("Checkpoint state has another layout");
+        };
+
+        inline void save(mapped_file& file, const D1::golden_state& s){
+            rv* out = file.stage();
+            const rv values[golden_size] = {s.a, s.b, s.c, s.d, s.vc, s.vd, s.h};
+            std::copy(values, values + golden_size, out);
+            file.commit(s.step, golden_size);
+        };
+
+        inline D1::golden_state load_golden(const mapped_file& file){
+            const rv* in = file.state();
+            return {in[0], in[1], in[2], in[3], in[4], in[5], in[6], file.step()};
+        };
+
+        inline void save(mapped_file& file, const grad::bfgs_state& s){
+            rv* out = file.stage();
+            out[0] = s.value;
+            out = std::copy(s.x.cbegin(), s.x.cend(), out + 1);
+            out = std::copy(s.g.cbegin(), s.g.cend(), out);
+            std::copy(s.h.cbegin(), s.h.cend(), out);
+            file.commit(s.step, bfgs_size(s.x.size()));
+        };
+
+        inline grad::bfgs_state load_bfgs(const mapped_file& file, const std::size_t n){
+            const rv* in = file.state() + 1;
+            return {vec(in, in + n), vec(in + n, in + 2 * n),
+                vec(in + 2 * n, in + 2 * n + n * n), file.state()[0], file.step()};
+        };
+
+        inline void save(mapped_file& file, const nelder_mead::simplex& s, const std::size_t step){
+            const std::size_t n = s.dim();
+            rv* out = file.stage();
+            out = std::copy(s.vertex(0), s.vertex(0) + (n + 1) * n, out);
+            for(std::size_t v = 0; v <= n; v++) out[v] = s.value(v);
+            std::copy(s.sum().cbegin(), s.sum().cend(), out + n + 1);
+            file.commit(step, nelder_mead_size(n));
+        };
+
+        inline void load(const mapped_file& file, nelder_mead::simplex& s){
+            const std::size_t n = s.dim();
+            const rv* in = file.state();
+            std::copy(in, in + (n + 1) * n, s.vertex(0));
+            in += (n + 1) * n;
+            for(std::size_t v = 0; v <= n; v++) s.value(v) = in[v];
+            std::copy(in + n + 1, in + 2 * n + 1, s.sum().begin());
+        };
+
+        // Resumable drivers: a non-empty file is continued without any
+        // re-evaluation, otherwise the run starts afresh. State is committed
+        // after every step and kept after the run ends.
+        template<typename Func>
+        std::pair<bool, rv> golden_ratio_minimize(const Func& f, const std::pair<rv, rv>& bounds,
+                const rv tol, const std::size_t max_steps, mapped_file& file){
+            require(file, golden_size);
+            D1::golden_state s;
+            if(file.empty()){
+                s = D1::golden_start(f, bounds);
+                save(file, s);
+            }else{
+                expect(file, golden_size);
+                s = load_golden(file);
+            };
+            return D1::golden_run(f, s, tol, max_steps,
+                [&file](const D1::golden_state& st){ save(file, st); });
+        };
+
+        template<typename Func>
+        grad::min_result_nd bfgs_minimize(const Func& f, const vec& x0,
+                const grad::params& p, mapped_file& file){
+            require(file, bfgs_size(x0.size()));
+            grad::bfgs_state s;
+            if(file.empty()){
+                s = grad::bfgs_start(f, x0, p);
+                save(file, s);
+            }else{
+                expect(file, bfgs_size(x0.size()));
+                s = load_bfgs(file, x0.size());
+            };
+            return grad::bfgs_run(f, s, p,
+                [&file](const grad::bfgs_state& st){ save(file, st); });
+        };
+
+        template<typename Func>
+        grad::min_result_nd nelder_mead_minimize(const Func& f, const vec& x0,
+                const nelder_mead::params& p, mapped_file& file){
+            require(file, nelder_mead_size(x0.size()));
+            nelder_mead::simplex s(x0, p);
+            std::size_t first = 0;
+            if(file.empty()){
+                nelder_mead::evaluate(f, s, p.threads);
+                save(file, s, 0);
+            }else{
+                expect(file, nelder_mead_size(x0.size()));
+                load(file, s);
+                first = file.step();
+            };
+            return nelder_mead::run(f, s, first, p,
+                [&file](const nelder_mead::simplex& st, const std::size_t step){ save(file, st, step); });
+        };
+    };
+};
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef CMAES
+#define CMAES
+
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <exception>
+#include <algorithm>
+
+#include <evaluate.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace cmaes{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        struct params{
+            std::size_t population = 0;
+            rv sigma = 0.5;
+            rv xtol = 1.e-10;
+            rv ftol = 1.e-12;
+            std::size_t max_generations = 10000;
+            std::uint64_t seed = 0;
+        };
+
+        // Cyclic Jacobi: a = v diag(w) v^T, a is destroyed; v and w preallocated
+        inline void jacobi_eigen(vec& a, const std::size_t n, vec& v, vec& w){
+            std::fill(v.begin(), v.end(), 0.);
+            for(std::size_t i = 0; i < n; i++) v[i * n + i] = 1.;
+            for(std::size_t sweep = 0; sweep < 64; sweep++){
+                rv off = 0., diag = 0.;
+                for(std::size_t i = 0; i < n; i++){
+                    diag += a[i * n + i] * a[i * n + i];
+                    for(std::size_t j = i + 1; j < n; j++) off += a[i * n + j] * a[i * n + j];
+                };
+                if(off <= 1.e-30 * diag) break;
+                for(std::size_t p = 0; p < n; p++){
+                    for(std::size_t q = p + 1; q < n; q++){
+                        const rv apq = a[p * n + q];
+                        if(apq == 0.) continue;
+                        const rv theta = (a[q * n + q] - a[p * n + p]) / (2. * apq);
+                        const rv t = std::copysign(1., theta) / (std::abs(theta) + std::sqrt(theta * theta + 1.));
+                        const rv c = 1. / std::sqrt(t * t + 1.), s = t * c;
+                        for(std::size_t k = 0; k < n; k++){
+                            const rv akp = a[k * n + p], akq = a[k * n + q];
+                            a[k * n + p] = c * akp - s * akq;
+                            a[k * n + q] = s * akp + c * akq;
+                        };
+                        for(std::size_t k = 0; k < n; k++){
+                            const rv apk = a[p * n + k], aqk = a[q * n + k];
+                            a[p * n + k] = c * apk - s * aqk;
+                            a[q * n + k] = s * apk + c * aqk;
+                        };
+                        for(std::size_t k = 0; k < n; k++){
+                            const rv vkp = v[k * n + p], vkq = v[k * n + q];
+                            v[k * n + p] = c * vkp - s * vkq;
+                            v[k * n + q] = s * vkp + c * vkq;
+                        };
+                    };
+                };
+            };
+            for(std::size_t i = 0; i < n; i++) w[i] = a[i * n + i];
+        };
+
+        // Strategy parameters and every per-generation buffer; sized once
+        struct state{
+            const std::size_t dim, lambda, mu;
+            vec weights;
+            rv mueff, cc, cs, c1, cmu, damps, chin;
+            vec mean, pc, ps, cov, basis, scales, work;
+            vec z, y, points, values, zw, yw;
+            std::vector<std::size_t> order;
+            rv sigma;
+            state(const vec& x0, const params& p):
+                dim(x0.size()),
+                lambda(p.population ? p.population :
+                    4 + static_cast<std::size_t>(3. * std::log(static_cast<rv>(x0.size())))),
+                mu(lambda / 2),
+                weights(mu),
+                mean(x0), pc(x0.size(), 0.), ps(x0.size(), 0.),
+                cov(x0.size() * x0.size(), 0.), basis(x0.size() * x0.size(), 0.),
+                scales(x0.size(), 1.), work(x0.size() * x0.size()),
+                z(lambda * x0.size()), y(lambda * x0.size()), points(lambda * x0.size()),
+                values(lambda), zw(x0.size()), yw(x0.size()),
+                order(lambda),
+                sigma(p.sigma)
+                {
+                    if(mu < 1) throw std::length_error("CMA-ES population should hold at least 2 points");
+                    const rv n = static_cast<rv>(dim);
+                    for(std::size_t i = 0; i < mu; i++)
+                        weights[i] = std::log(static_cast<rv>(mu) + 0.5) - std::log(static_cast<rv>(i + 1));
+                    const rv sw = std::accumulate(weights.cbegin(), weights.cend(), 0.);
+                    for(auto& w : weights) w /= sw;
+                    mueff = 1. / std::inner_product(weights.cbegin(), weights.cend(), weights.cbegin(), 0.);
+                    cc = (4. + mueff / n) / (n + 4. + 2. * mueff / n);
+                    cs = (mueff + 2.) / (n + mueff + 5.);
+                    c1 = 2. / ((n + 1.3) * (n + 1.3) + mueff);
+                    cmu = std::min(1. - c1, 2. * (mueff - 2. + 1. / mueff) / ((n + 2.) * (n + 2.) + mueff));
+                    damps = 1. + 2. * std::max(0., std::sqrt((mueff - 1.) / (n + 1.)) - 1.) + cs;
+                    chin = std::sqrt(n) * (1. - 1. / (4. * n) + 1. / (21. * n * n));
+                    for(std::size_t i = 0; i < dim; i++) cov[i * dim + i] = basis[i * dim + i] = 1.;
+                };
+        };
+
+        template<typename Gen>
+        void sample(state& s, Gen& gen){
+            const std::size_t n = s.dim;
+            std::normal_distribution<rv> normal(0., 1.);
+            for(std::size_t k = 0; k < s.lambda; k++){
+                const auto zk = s.z.begin() + k * n, yk = s.y.begin() + k * n,
+                           xk = s.points.begin() + k * n;
+                for(std::size_t j = 0; j < n; j++) zk[j] = normal(gen);
+                for(std::size_t i = 0; i < n; i++){
+                    rv v = 0.;
+                    for(std::size_t j = 0; j < n; j++) v += s.basis[i * n + j] * s.scales[j] * zk[j];
+                    yk[i] = v;
+                    xk[i] = s.mean[i] + s.sigma * v;
+                };
+            };
+        };
+
+        inline void update(state& s, const std::size_t generation){
+            const std::size_t n = s.dim;
+            std::iota(s.order.begin(), s.order.end(), 0);
+            std::sort(s.order.begin(), s.order.end(),
+                [&s](const std::size_t a, const std::size_t b){ return s.values[a] < s.values[b]; });
+            std::fill(s.zw.begin(), s.zw.end(), 0.);
+            std::fill(s.yw.begin(), s.yw.end(), 0.);
+            for(std::size_t i = 0; i < s.mu; i++){
+                const std::size_t k = s.order[i];
+                for(std::size_t j = 0; j < n; j++){
+                    s.zw[j] += s.weights[i] * s.z[k * n + j];
+                    s.yw[j] += s.weights[i] * s.y[k * n + j];
+                };
+            };
+            for(std::size_t j = 0; j < n; j++) s.mean[j] += s.sigma * s.yw[j];
+            // C^(-1/2) y_w = B z_w
+            const rv ks = std::sqrt(s.cs * (2. - s.cs) * s.mueff);
+            for(std::size_t i = 0; i < n; i++){
+                rv v = 0.;
+                for(std::size_t j = 0; j < n; j++) v += s.basis[i * n + j] * s.zw[j];
+                s.ps[i] = (1. - s.cs) * s.ps[i] + ks * v;
+            };
+            const rv psn = std::sqrt(std::inner_product(s.ps.cbegin(), s.ps.cend(), s.ps.cbegin(), 0.));
+            const rv decay = 1. - std::pow(1. - s.cs, 2. * static_cast<rv>(generation + 1));
+            const bool hsig = psn / std::sqrt(decay) / s.chin < 1.4 + 2. / (static_cast<rv>(n) + 1.);
+            const rv kc = std::sqrt(s.cc * (2. - s.cc) * s.mueff);
+            for(std::size_t j = 0; j < n; j++)
+                s.pc[j] = (1. - s.cc) * s.pc[j] + (hsig ? kc * s.yw[j] : 0.);
+            const rv keep = 1. - s.c1 - s.cmu + (hsig ? 0. : s.c1 * s.cc * (2. - s.cc));
+            for(std::size_t a = 0; a < n; a++){
+                for(std::size_t b = 0; b <= a; b++){
+                    rv rank_mu = 0.;
+                    for(std::size_t i = 0; i < s.mu; i++){
+                        const std::size_t k = s.order[i];
+                        rank_mu += s.weights[i] * s.y[k * n + a] * s.y[k * n + b];
+                    };
+                    const rv v = keep * s.cov[a * n + b] + s.c1 * s.pc[a] * s.pc[b] + s.cmu * rank_mu;
+                    s.cov[a * n + b] = s.cov[b * n + a] = v;
+                };
+            };
+            s.sigma *= std::exp((s.cs / s.damps) * (psn / s.chin - 1.));
+        };
+
+        inline void decompose(state& s){
+            std::copy(s.cov.cbegin(), s.cov.cend(), s.work.begin());
+            jacobi_eigen(s.work, s.dim, s.basis, s.scales);
+            for(auto& d : s.scales) d = std::sqrt(std::max(d, 1.e-300));
+        };
+
+        template<typename Eval>
+        grad::min_result_nd minimize_batched(const Eval& eval, state& s, const params& p = {}){
+            const std::size_t n = s.dim;
+            std::mt19937_64 gen(p.seed);
+            const rv rate = static_cast<rv>(n) * (s.c1 + s.cmu);
+            const std::size_t eigen_every = std::max<std::size_t>(1, static_cast<std::size_t>(0.1 / rate));
+            vec best(s.mean);
+            rv best_value = std::numeric_limits<rv>::infinity();
+            for(std::size_t gn = 0; gn < p.max_generations; gn++){
+                sample(s, gen);
+                eval(s.points, n, s.values);
+                const auto mm = std::minmax_element(s.values.cbegin(), s.values.cend());
+                if(*mm.first < best_value){
+                    best_value = *mm.first;
+                    const auto bx = s.points.cbegin() + std::distance(s.values.cbegin(), mm.first) * n;
+                    std::copy(bx, bx + n, best.begin());
+                };
+                update(s, gn);
+                if((gn + 1) % eigen_every == 0) decompose(s);
+                const rv spread = s.sigma * *std::max_element(s.scales.cbegin(), s.scales.cend());
+                if((spread < p.xtol) || ((*mm.second - *mm.first < p.ftol) && (gn > 0)))
+                    return {true, best, best_value, gn + 1};
+            };
+            return {false, best, best_value, p.max_generations};
+        };
+
+        template<typename Func>
+        grad::min_result_nd minimize(const Func& f, const vec& x0,
+                const params& p = {}, const std::size_t threads = 1){
+            state s(x0, p);
+            const evaluate::parallel_evaluator<Func> eval(f, threads);
+            return minimize_batched(eval, s, p);
+        };
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef COORDINATE_DESCENT
+#define COORDINATE_DESCENT
+
+#include <limits>
+#include <vector>
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <ranges.hpp>
+#include <minimize_1d.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace coordinate{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        struct params{
+            rv xtol = 1.e-8;
+            rv ftol = 1.e-14;
+            std::size_t max_sweeps = 1000;
+            // First bracket half-width per axis; later ones follow the last move
+            rv radius = 1.;
+            rv min_radius = 1.e-6;
+            rv line_tol = 1.e-10;
+            std::size_t line_steps = 256;
+        };
+
+        // f.delta(x, i, v) returns f(x with x[i] = v) - f(x)
+        template<typename Func, typename = void>
+        struct has_delta : std::false_type{};
+
+        template<typename Func>
+        struct has_delta<Func, std::void_t<decltype(std::declval<const Func&>().delta(
+            std::declval<const vec&>(), std::size_t(), rv()))> > : std::true_type{};
+
+        template<typename Func>
+        rv axis_value(const Func& f, const vec& x, const std::size_t i, const rv v, const rv value){
+            if constexpr(has_delta<Func>::value){
+                return value + f.delta(x, i, v);
+            }else{
+                return f(ranges::subs_range(x, {i, v}));
+            };
+        };
+
+        // Cyclic coordinate descent, golden-section search along each axis
+        // inside a bracket grown from the previous move. With f.delta an
+        // axis costs O(1) per evaluation; the value is refreshed by one full
+        // evaluation per sweep to stop rounding drift.
+        template<typename Func>
+        grad::min_result_nd minimize(const Func& f, const vec& x0, const params& p = {}){
+            const std::size_t n = x0.size();
+            const rv big = std::numeric_limits<rv>::max();
+            const std::pair<rv, rv> bounds{- big, big};
+            vec x(x0), radius(n, p.radius);
+            rv value = f(ranges::const_range(x));
+            for(std::size_t sweep = 0; sweep < p.max_sweeps; sweep++){
+                const rv start = value;
+                rv moved = 0.;
+                for(std::size_t i = 0; i < n; i++){
+                    const rv xi = x[i];
+                    const auto phi = [&](const rv v){ return axis_value(f, x, i, v, value); };
+                    const auto line = D1::golden_ratio_minimize(phi, bounds, p.line_tol, p.line_steps,
+                        D1::warm_start{xi, radius[i]});
+                    const rv trial = phi(line.second);
+                    if(trial < value){
+                        x[i] = line.second;
+                        value = trial;
+                    };
+                    const rv step = std::abs(x[i] - xi);
+                    moved = std::max(moved, step);
+                    radius[i] = std::max(2. * step, p.min_radius);
+                };
+                if constexpr(has_delta<Func>::value) value = f(ranges::const_range(x));
+                if((moved <= p.xtol) || (start - value <= p.ftol))
+                    return {true, x, value, sweep + 1};
+            };
+            return {false, x, value, p.max_sweeps};
+        };
+    };
+};
+
+#endif
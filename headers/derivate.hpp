@@ -2,16 +2,20 @@
 #define DERIVATE
 
 #include <array>
+#include <vector>
 #include <numeric>
 #include <utility>
 #include <exception>
 #include <algorithm>
 #include <functional>
+#include <type_traits>
 
 #include <iostream>
 
 #include <ranges.hpp>
 #include <operations.hpp>
+#include <sparse.hpp>
+#include <instrument.hpp>
 
 namespace minimize{
     namespace derivate{
@@ -44,7 +48,29 @@ namespace minimize{
                 return ret_val;
             };
             constexpr derivative_props<4> four{{1., -8., 8., -1}, 12.};
-            constexpr derivative_props<3> three{{-1., 1.}, 2.};
+            constexpr derivative_props<3> three{{-1., 0., 1.}, 2.};
+        };
+
+        // Stencil values and their weighted sums are kept in at least
+        // double: float ranges and objectives get double reductions and
+        // coefficients, long double ones keep their own precision
+        template<typename T>
+        using accum_t = std::common_type_t<rv, T>;
+
+        template<typename Range>
+        using range_accum_t = accum_t<typename Range::value_type>;
+
+        // Default stencil step for coordinates of type T. Steps other than
+        // double's are powers of two so that x + h is exact for moderate x.
+        template<typename T>
+        constexpr rv default_step(void){
+            if constexpr(std::is_same<T, float>::value){
+                return 1. / 1024.;
+            }else if constexpr(sizeof(T) > sizeof(double)){
+                return 1. / 65536.;
+            }else{
+                return 1.e-8;
+            };
         };
 
         template<typename Range>
@@ -54,12 +80,12 @@ namespace minimize{
         };
 
         template<typename Func, typename Range, std::size_t p_num>
-        std::array<rv, p_num> values_by_axis(
+        std::array<range_accum_t<Range>, p_num> values_by_axis(
                 const std::array<rv, p_num>& shifts,
                 const Func& func, 
                 const Range& r, 
                 const std::size_t d){
-            std::array<rv, p_num> ret_val;
+            std::array<range_accum_t<Range>, p_num> ret_val;
             std::transform(shifts.cbegin(), shifts.cend(), ret_val.begin(),
                 [&](const double sh){ 
                     const auto nx = shifted_x(r, d, sh);
@@ -79,26 +105,28 @@ namespace minimize{
         };
 
         template<typename T, typename R>
-        double compute_derivation(const T& vals, const R& dpr, const rv h){
-            rv ret_val = std::inner_product(vals.cbegin(), vals.cend(), 
-                dpr.coeffs.cbegin(), 0.);
-            return ret_val / (dpr.multiplier * h);
+        auto compute_derivation(const T& vals, const R& dpr, const rv h){
+            using acc = typename T::value_type;
+            const acc ret_val = std::inner_product(vals.cbegin(), vals.cend(), 
+                dpr.coeffs.cbegin(), acc(0));
+            return ret_val / (acc(dpr.multiplier) * acc(h));
         };
 
         template<typename Func, typename Range, std::size_t p_num>
-        double derive_by_axis(const Func& func, const Range& r, const std::size_t d, 
+        range_accum_t<Range> derive_by_axis(const Func& func, const Range& r, const std::size_t d, 
                 const rv h, const constants::derivative_props<p_num>& p){
             using arr = std::array<rv, p_num>;
             const arr shifts(p.shifts(h));
-            const arr vals(std::move(
+            const auto vals(std::move(
                 values_by_axis<Func, Range, p_num>(shifts, func, r, d)));
             return compute_derivation(vals, p, h);
         };
 
 
         template<typename Func, typename Range>
-        double derive_by_axis(const Func& func,
-                const Range& r, const std::size_t d, const rv h = 1.e-8){
+        range_accum_t<Range> derive_by_axis(const Func& func,
+                const Range& r, const std::size_t d,
+                const rv h = default_step<typename Range::value_type>()){
             return derive_by_axis(func, r, d, h, constants::four);
         };  
 
@@ -121,61 +149,191 @@ namespace minimize{
         };
 
         template<typename Func, typename Range>
-        double derive_by_axis_3(const Func& func,
-                const Range& r, const std::size_t d, const rv h = 1.e-8){
+        range_accum_t<Range> derive_by_axis_3(const Func& func,
+                const Range& r, const std::size_t d,
+                const rv h = default_step<typename Range::value_type>()){
             return derive_by_axis(func, r, d, h, constants::three);
         };   
 
-        template<typename Func, typename Range>
-        std::vector<rv> auto_grad(const Func& func, const Range& r, 
-                const rv h = 1.e-8){
-            std::vector<rv> ret_val(r.size());
+        // policy counts the stencil evaluations and times one gradient phase
+        template<typename Func, typename Range, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        std::vector<range_accum_t<Range> > auto_grad(const Func& func, const Range& r, 
+                const rv h = default_step<typename Range::value_type>(), Policy&& policy = Policy()){
+            const instrument::scope<std::remove_reference_t<Policy> > timed(policy, instrument::phase::gradient);
+            const auto fc = instrument::counted(func, policy);
+            std::vector<range_accum_t<Range> > ret_val(r.size());
             for(std::size_t i = 0; i < ret_val.size(); i++){
-                ret_val.at(i) = derive_by_axis(func, r, i, h);
+                ret_val.at(i) = derive_by_axis(fc, r, i, h);
             };
             return ret_val;
         };
 
+        // Writes the gradient into out[0], ..., out[r.size() - 1] without
+        // allocating
+        template<typename Func, typename Range>
+        void auto_grad(const Func& func, const Range& r, range_accum_t<Range>* out,
+                const rv h = default_step<typename Range::value_type>()){
+            for(std::size_t i = 0; i < r.size(); i++) out[i] = derive_by_axis(func, r, i, h);
+        };
+
+        // Gradient entries at the increasing positions in pattern only;
+        // the rest are taken as zero and never evaluated
+        template<typename Func, typename Range>
+        ranges::sparse_vector<range_accum_t<Range> > sparse_grad(const Func& func, const Range& r,
+                const std::vector<std::size_t>& pattern,
+                const rv h = default_step<typename Range::value_type>()){
+            std::vector<range_accum_t<Range> > values(pattern.size());
+            for(std::size_t k = 0; k < pattern.size(); k++) values[k] = derive_by_axis(func, r, pattern[k], h);
+            return ranges::sparse_vector<range_accum_t<Range> >(r.size(), pattern, std::move(values));
+        };
+
+        // f.value_and_gradient(x, g) returns f(x) and writes the gradient
+        // into g (sized like x) in one pass
+        template<typename Func, typename = void>
+        struct has_value_and_gradient : std::false_type{};
+
+        template<typename Func>
+        struct has_value_and_gradient<Func, std::void_t<decltype(
+            std::declval<const Func&>().value_and_gradient(
+                std::declval<const std::vector<rv>&>(), std::declval<std::vector<rv>&>()))> >
+            : std::true_type{};
+
+        // Analytic when the functor provides it, four-point stencils otherwise
+        template<typename Func>
+        rv value_and_grad(const Func& func, const std::vector<rv>& x,
+                std::vector<rv>& g, const rv h = 1.e-8){
+            if constexpr(has_value_and_gradient<Func>::value){
+                g.resize(x.size());
+                return func.value_and_gradient(x, g);
+            }else{
+                const auto xr = ranges::const_range(x);
+                g.resize(x.size());
+                auto_grad(func, xr, g.data(), h);
+                return func(xr);
+            };
+        };
+
+        // Hessian (row-major) from central differences of an analytic gradient
+        template<typename Func>
+        std::vector<rv> gradient_hessian(const Func& func, const std::vector<rv>& x,
+                const rv h = 1.e-5){
+            const std::size_t n = x.size();
+            std::vector<rv> hess(n * n), xs(x), gp(n), gm(n);
+            for(std::size_t j = 0; j < n; j++){
+                xs.at(j) = x.at(j) + h;
+                func.value_and_gradient(xs, gp);
+                xs.at(j) = x.at(j) - h;
+                func.value_and_gradient(xs, gm);
+                xs.at(j) = x.at(j);
+                for(std::size_t i = 0; i < n; i++) hess.at(i * n + j) = (gp.at(i) - gm.at(i)) / (2. * h);
+            };
+            for(std::size_t i = 0; i < n; i++){
+                for(std::size_t j = i + 1; j < n; j++){
+                    const rv hij = 0.5 * (hess.at(i * n + j) + hess.at(j * n + i));
+                    hess.at(i * n + j) = hess.at(j * n + i) = hij;
+                };
+            };
+            return hess;
+        };
+
+        // Central gradient and Hessian (row-major) sharing f0 = f(x) and
+        // f(x +- h e_i); off-diagonal terms reuse f(x + h e_i) and need one
+        // extra value each
+        template<typename Func, typename Range>
+        std::pair<std::vector<rv>, std::vector<rv> > auto_grad_hessian(
+                const Func& func, const Range& r, const rv f0, const rv h){
+            const std::size_t n = r.size();
+            std::vector<rv> grad(n), hess(n * n), fp(n), xi(n);
+            for(std::size_t i = 0; i < n; i++) xi.at(i) = r.at(i);
+            for(std::size_t i = 0; i < n; i++){
+                fp.at(i) = func(shifted_x(r, i, h));
+                const rv fm = func(shifted_x(r, i, -h));
+                grad.at(i) = (fp.at(i) - fm) / (2. * h);
+                hess.at(i * n + i) = (fp.at(i) - 2. * f0 + fm) / (h * h);
+            };
+            for(std::size_t i = 0; i < n; i++){
+                xi.at(i) += h;
+                const auto xr = ranges::const_range(xi);
+                for(std::size_t j = i + 1; j < n; j++){
+                    const rv fij = func(shifted_x(xr, j, h));
+                    const rv hij = (fij - fp.at(i) - fp.at(j) + f0) / (h * h);
+                    hess.at(i * n + j) = hess.at(j * n + i) = hij;
+                };
+                xi.at(i) = r.at(i);
+            };
+            return {std::move(grad), std::move(hess)};
+        };
+
+        template<typename Func, typename Range>
+        std::pair<std::vector<rv>, std::vector<rv> > auto_grad_hessian(
+                const Func& func, const Range& r, const rv h = 1.e-5){
+            return auto_grad_hessian(func, r, static_cast<rv>(func(r)), h);
+        };
+
+        template<typename Func, typename Range>
+        std::vector<rv> auto_hessian(const Func& func, const Range& r, 
+                const rv h = 1.e-5){
+            return auto_grad_hessian(func, r, h).second;
+        };
+
+        // Contiguous double points are shifted by the fused affine range
+        template<typename Range1, typename Range2>
+        constexpr bool fused_shift = ranges::contiguous<Range1>::value && ranges::contiguous<Range2>::value
+            && std::is_same<typename Range1::value_type, rv>::value
+            && std::is_same<typename Range2::value_type, rv>::value;
+
         template<typename Range1, typename Range2>
         auto shifted_by_direction(const Range1& r, const Range2& d, const rv& h){
-            const auto dr = ranges::ops::scalar_mul(h, d);
-            return ranges::ops::sum(r, dr);
+            if constexpr(fused_shift<Range1, Range2>){
+                return ranges::ops::axpy(r, h, d);
+            }else{
+                const auto dr = ranges::ops::scalar_mul(h, d);
+                return ranges::ops::sum(r, dr);
+            };
         };
 
         template<typename Func, typename Range1, typename Range2, std::size_t p_num>
-        std::array<rv, p_num> values_by_direction(
+        std::array<range_accum_t<Range1>, p_num> values_by_direction(
                 const std::array<rv, p_num> shifts,
                 const Func& func, 
                 const Range1& r, 
                 const Range2& d){
-            std::array<rv, p_num> ret_val;
+            std::array<range_accum_t<Range1>, p_num> ret_val;
             std::transform(shifts.cbegin(), shifts.cend(), ret_val.begin(),
                 [&](const double sh){ 
                     const auto nx = shifted_by_direction(r, d, sh);
-                    return func(nx);
+                    // Small expression ranges are evaluated once up front
+                    if constexpr(!fused_shift<Range1, Range2>){
+                        if(nx.size() <= ranges::cached_range<typename decltype(nx)::value_type>::inline_capacity)
+                            return static_cast<range_accum_t<Range1> >(func(ranges::cached(nx)));
+                    };
+                    return static_cast<range_accum_t<Range1> >(func(nx));
                 });
             return ret_val;
         };
 
         template<typename Func, typename Range1, typename Range2, std::size_t p_num>
-        double derive_by_directiona(const Func& func,
+        range_accum_t<Range1> derive_by_directiona(const Func& func,
                 const Range1& r, const Range2& d, const rv& h, const constants::derivative_props<p_num>& p){
             using arr = std::array<rv, p_num>;
             const arr shifts(p.shifts(h));
-            const arr vals(std::move(
+            const auto vals(std::move(
                 values_by_direction<Func, Range1, Range2, p_num>(shifts, func, r, d)));
             return compute_derivation(vals, p, h);
         };
 
         template<typename Func, typename Range1, typename Range2>
-        double derive_by_direction(const Func& func,
-                const Range1& r, const Range2& d, const rv& h = 1.e-8){
+        range_accum_t<Range1> derive_by_direction(const Func& func,
+                const Range1& r, const Range2& d,
+                const rv& h = default_step<typename Range1::value_type>()){
             return derive_by_directiona<Func, Range1, Range2, 4>(func, r, d, h, constants::four);
         };
 
         template<typename Func, typename Range1, typename Range2>
-        double derive_by_direction_3(const Func& func,
-                const Range1& r, const Range2& d, const rv& h = 1.e-8){
+        range_accum_t<Range1> derive_by_direction_3(const Func& func,
+                const Range1& r, const Range2& d,
+                const rv& h = default_step<typename Range1::value_type>()){
             return derive_by_directiona<Func, Range1, Range2, 3>(func, r, d, h, constants::three);
         };
     };
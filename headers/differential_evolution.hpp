@@ -0,0 +1,120 @@
+#ifndef DIFFERENTIAL_EVOLUTION
+#define DIFFERENTIAL_EVOLUTION
+
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include <cmath>
+#include <utility>
+#include <exception>
+#include <algorithm>
+
+#include <evaluate.hpp>
+#include <sampling.hpp>
+#include <box_minimize.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace differential_evolution{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        struct params{
+            std::size_t population = 0;
+            rv weight = 0.8;
+            rv crossover = 0.9;
+            rv ftol = 1.e-10;
+            std::size_t max_generations = 2000;
+            std::uint64_t seed = 0;
+        };
+
+        // Whole generation in contiguous blocks, allocated once
+        struct population{
+            const std::size_t size, dim;
+            vec points, values, trials, trial_values;
+            population(const std::size_t count, const std::size_t n):
+                size(count), dim(n),
+                points(count * n), values(count),
+                trials(count * n), trial_values(count)
+                {};
+        };
+
+        inline std::size_t default_population(const std::size_t n){
+            return std::max<std::size_t>(10 * n, 8);
+        };
+
+        // DE/rand/1/bin; coordinates leaving the box are bounced halfway
+        // back towards the parent
+        template<typename Gen>
+        void make_trials(population& pop, const box::bounds& b, const params& p, Gen& gen){
+            const std::size_t m = pop.size, n = pop.dim;
+            std::uniform_int_distribution<std::size_t> pick(0, m - 1), axis(0, n - 1);
+            std::uniform_real_distribution<rv> u(0., 1.);
+            for(std::size_t i = 0; i < m; i++){
+                std::size_t r1, r2, r3;
+                do{ r1 = pick(gen); }while(r1 == i);
+                do{ r2 = pick(gen); }while((r2 == i) || (r2 == r1));
+                do{ r3 = pick(gen); }while((r3 == i) || (r3 == r1) || (r3 == r2));
+                const std::size_t jr = axis(gen);
+                const auto x = pop.points.cbegin() + i * n,
+                           a = pop.points.cbegin() + r1 * n,
+                           c = pop.points.cbegin() + r2 * n,
+                           d = pop.points.cbegin() + r3 * n;
+                const auto t = pop.trials.begin() + i * n;
+                for(std::size_t j = 0; j < n; j++){
+                    const bool cross = (j == jr) || (u(gen) < p.crossover);
+                    rv v = cross ? a[j] + p.weight * (c[j] - d[j]) : x[j];
+                    if(v < b.lower[j]) v = 0.5 * (b.lower[j] + x[j]);
+                    if(v > b.upper[j]) v = 0.5 * (b.upper[j] + x[j]);
+                    t[j] = v;
+                };
+            };
+        };
+
+        template<typename Eval>
+        grad::min_result_nd minimize_batched(const Eval& eval, const box::bounds& b,
+                population& pop, const params& p = {}){
+            const std::size_t m = pop.size, n = pop.dim;
+            if((b.dim() != n) || (m < 4))
+                throw std::length_error("Population should match bounds and hold at least 4 points");
+            std::mt19937_64 gen(p.seed);
+            vec init = sampling::latin_hypercube(m, n, gen);
+            sampling::scale(init, b.lower, b.upper);
+            std::copy(init.cbegin(), init.cend(), pop.points.begin());
+            eval(pop.points, n, pop.values);
+            std::size_t best = 0;
+            for(std::size_t gn = 0; gn < p.max_generations; gn++){
+                const auto mm = std::minmax_element(pop.values.cbegin(), pop.values.cend());
+                best = std::distance(pop.values.cbegin(), mm.first);
+                if(*mm.second - *mm.first <= p.ftol){
+                    const auto bx = pop.points.cbegin() + best * n;
+                    return {true, vec(bx, bx + n), pop.values[best], gn};
+                };
+                make_trials(pop, b, p, gen);
+                eval(pop.trials, n, pop.trial_values);
+                for(std::size_t i = 0; i < m; i++){
+                    if(!(pop.trial_values[i] <= pop.values[i])) continue;
+                    std::copy(pop.trials.cbegin() + i * n, pop.trials.cbegin() + (i + 1) * n,
+                        pop.points.begin() + i * n);
+                    pop.values[i] = pop.trial_values[i];
+                };
+            };
+            best = std::distance(pop.values.cbegin(),
+                std::min_element(pop.values.cbegin(), pop.values.cend()));
+            const auto bx = pop.points.cbegin() + best * n;
+            return {false, vec(bx, bx + n), pop.values[best], p.max_generations};
+        };
+
+        template<typename Func>
+        grad::min_result_nd minimize(const Func& f, const box::bounds& b,
+                const params& p = {}, const std::size_t threads = 1){
+            const std::size_t n = b.dim();
+            population pop(p.population ? p.population : default_population(n), n);
+            const evaluate::parallel_evaluator<Func> eval(f, threads);
+            return minimize_batched(eval, b, pop, p);
+        };
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef EVALUATE
+#define EVALUATE
+
+#include <vector>
+#include <exception>
+
+#include <ranges.hpp>
+#include <parallel.hpp>
+#include <derivate.hpp>
+
+namespace minimize{
+    namespace evaluate{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        // Batched evaluators are called as eval(points, n, values): points
+        // holds values.size() rows of n coordinates, one objective value
+        // is written per row
+        template<typename Func>
+        class serial_evaluator{
+            protected:
+                const Func& _func;
+            public:
+                explicit serial_evaluator(const Func& func):
+                    _func(func)
+                    {};
+                void operator()(const vec& points, const std::size_t n, vec& values) const{
+                    for(std::size_t i = 0; i < values.size(); i++){
+                        const auto row = points.cbegin() + i * n;
+                        values[i] = _func(ranges::const_range<vec>(row, row + n));
+                    };
+                };
+        };
+
+        template<typename Func>
+        class parallel_evaluator{
+            protected:
+                const Func& _func;
+                const std::size_t _threads;
+            public:
+                parallel_evaluator(const Func& func,
+                        const std::size_t threads = parallel::hardware_threads()):
+                    _func(func), _threads(threads)
+                    {};
+                void operator()(const vec& points, const std::size_t n, vec& values) const{
+                    if(points.size() != values.size() * n)
+                        throw std::length_error("Points should hold one row per value");
+                    parallel::parallel_for(values.size(), _threads, [&](const std::size_t i){
+                        const auto row = points.cbegin() + i * n;
+                        values[i] = _func(ranges::const_range<vec>(row, row + n));
+                    });
+                };
+        };
+
+        // Rows of the four-point stencil of every axis, 4n rows of n
+        inline void gradient_stencil(const vec& x, const rv h, vec& points){
+            const auto shifts = derivate::constants::four.shifts(h);
+            const std::size_t n = x.size(), k = shifts.size();
+            points.resize(k * n * n);
+            for(std::size_t i = 0; i < n; i++){
+                for(std::size_t s = 0; s < k; s++){
+                    const auto row = points.begin() + (i * k + s) * n;
+                    std::copy(x.cbegin(), x.cend(), row);
+                    row[i] += shifts[s];
+                };
+            };
+        };
+
+        inline void gradient_from_stencil(const vec& values, const rv h, vec& out){
+            const auto& dp = derivate::constants::four;
+            const std::size_t k = dp.coeffs.size();
+            for(std::size_t i = 0; i < out.size(); i++){
+                rv g = 0.;
+                for(std::size_t s = 0; s < k; s++) g += dp.coeffs[s] * values[i * k + s];
+                out[i] = g / (dp.multiplier * h);
+            };
+        };
+
+        // Stencil rows and their values for one dimension
+        struct gradient_workspace{
+            vec points, values;
+            explicit gradient_workspace(const std::size_t n):
+                points(4 * n * n), values(4 * n)
+                {};
+        };
+
+        // derivate::auto_grad with the whole stencil sent as one batch;
+        // out must hold x.size() values
+        template<typename Eval>
+        void auto_grad(const Eval& eval, const vec& x, vec& out, gradient_workspace& ws,
+                const rv h = 1.e-8){
+            if(ws.values.size() != 4 * x.size())
+                throw std::length_error("Workspace should match problem size");
+            gradient_stencil(x, h, ws.points);
+            eval(ws.points, x.size(), ws.values);
+            gradient_from_stencil(ws.values, h, out);
+        };
+
+        template<typename Eval>
+        vec auto_grad(const Eval& eval, const vec& x, const rv h = 1.e-8){
+            gradient_workspace ws(x.size());
+            vec ret_val(x.size());
+            auto_grad(eval, x, ret_val, ws, h);
+            return ret_val;
+        };
+    };
+};
+
+#endif
\ No newline at end of file
@@ -1,9 +1,7 @@
 #ifndef GRAD_MINIMIZE
 #define GRAD_MINIMIZE
 
-#define FPHI 0.618033988749894848204586834365638117720309179805762862135
-#define SPHI 0.381966011250105151795413165634361882279690820194237137864
-
+#include <limits>
 #include <vector>
 
 #include <cmath>
@@ -16,55 +14,337 @@
 #include <ranges.hpp>
 #include <operations.hpp>
 #include <derivate.hpp>
+#include <line_search.hpp>
+#include <minimize_1d.hpp>
+#include <instrument.hpp>
 
 namespace minimize{
     namespace grad{
         using rv = double;
         using vec = std::vector<double>;
 
+        enum class search{
+            wolfe,
+            golden
+        };
+
+        struct params{
+            rv tol = 1.e-6;
+            std::size_t max_steps = 1024;
+            rv h = 1.e-8;
+            search line = search::wolfe;
+            line_search::wolfe_params wolfe = {};
+            rv golden_tol = 1.e-8;
+            rv golden_bound = 4.;
+        };
+
+        struct min_result_nd{
+            bool status;
+            vec x;
+            rv value;
+            std::size_t steps;
+        };
+
+        inline rv dot(const vec& a, const vec& b){
+            return std::inner_product(a.cbegin(), a.cend(), b.cbegin(), 0.);
+        };
+
+        inline rv norm(const vec& a){
+            return std::sqrt(dot(a, a));
+        };
+
         template<typename Func>
-        std::pair<bool, rv> golden_ratio_minimize(
-                const Func& f, 
-                const std::pair<rv, rv>& bounds, 
-                const rv& tol,
-                const std::size_t& max_steps){
-            rv a = std::min(bounds.first, bounds.second), 
-               b = std::max(bounds.first, bounds.second);
-            rv h = b - a;
-            rv c, d, vc, vd;
-            {
-                c = a + h * SPHI, d = a + h * FPHI;
-                vc = f(c), vd = f(d);
+        vec gradient(const Func& f, const vec& x, const rv h){
+            if constexpr(derivate::has_value_and_gradient<Func>::value){
+                vec ret_val(x.size());
+                f.value_and_gradient(x, ret_val);
+                return ret_val;
+            }else{
+                return derivate::auto_grad(f, ranges::const_range(x), h);
             };
-            for(std::size_t step = 0; (step < max_steps) && (tol < h); step++){
-                if(vc < vd){
-                    b = d; d = c;
-                    vd = vc;
-                    h = h * FPHI;
-                    c = a + h * SPHI;
-                    vc = f(c);
-                }else{
-                    a = c; c = d;
-                    vc = vd;
-                    h = h * FPHI;
-                    d = a + h * FPHI;
-                    vd = f(d);
-                };
+        };
+
+        // Buffers of one gradient solver run, sized once from the
+        // dimension so that iterations do not touch the allocator. Taken
+        // by steepest_descent, bfgs_run and bfgs_minimize; the trust
+        // region, least-squares, box and batch solvers still size their
+        // own buffers per call.
+        struct workspace{
+            vec d, s, y, gn, trial, grad, hy;
+            explicit workspace(const std::size_t n):
+                d(n), s(n), y(n), gn(n), trial(n), grad(n), hy(n)
+                {};
+            std::size_t dim(void) const{
+                return d.size();
             };
-            if(vc < vd){
-                return {(tol > h), 0.5 * (a + d)};
-            }else{
-                return {(tol > h), 0.5 * (b + c)};
+        };
+
+        // phi(alpha) = f(x + alpha * d) and its slope along d; with an
+        // analytic gradient the one at the last trial is kept for reuse.
+        // Trial points and gradients live in the workspace.
+        template<typename Func>
+        class direction_function{
+            protected:
+                static constexpr bool analytic = derivate::has_value_and_gradient<Func>::value;
+                const Func& _func;
+                const vec& _x;
+                const vec& _d;
+                const rv _h;
+                vec& _trial;
+                vec& _grad;
+                mutable rv _grad_alpha;
+            public:
+                direction_function(const Func& func, const vec& x, const vec& d, const rv h, workspace& ws):
+                    _func(func), _x(x), _d(d), _h(h), _trial(ws.trial), _grad(ws.grad),
+                    _grad_alpha(std::numeric_limits<rv>::quiet_NaN())
+                    {};
+                const vec& trial(const rv alpha) const{
+                    ranges::ops::axpy(_x, alpha, _d).materialize(_trial.data());
+                    return _trial;
+                };
+                rv value(const rv alpha) const{
+                    return _func(ranges::const_range(trial(alpha)));
+                };
+                std::pair<rv, rv> operator()(const rv alpha) const{
+                    if constexpr(analytic){
+                        const rv value = _func.value_and_gradient(trial(alpha), _grad);
+                        _grad_alpha = alpha;
+                        return {value, dot(_grad, _d)};
+                    }else{
+                        const auto tr = ranges::const_range(trial(alpha)),
+                                   dr = ranges::const_range(_d);
+                        return {_func(tr), derivate::derive_by_direction(_func, tr, dr, _h)};
+                    };
+                };
+                void gradient_at(const rv alpha, vec& out) const{
+                    if constexpr(analytic){
+                        if(alpha != _grad_alpha){
+                            _func.value_and_gradient(trial(alpha), _grad);
+                            _grad_alpha = alpha;
+                        };
+                        std::copy(_grad.cbegin(), _grad.cend(), out.begin());
+                    }else{
+                        derivate::auto_grad(_func, ranges::const_range(trial(alpha)), out.data(), _h);
+                    };
+                };
+        };
+
+        template<typename Func>
+        std::pair<bool, line_search::point> golden_search(
+                const direction_function<Func>& phi, const rv value0,
+                const rv alpha0, const params& p){
+            const auto fv = [&](const rv alpha){ return phi.value(alpha); };
+            const std::pair<rv, rv> bounds{0., p.golden_bound * alpha0};
+            const auto steps = std::log(p.golden_tol / bounds.second) / std::log(FPHI);
+            const auto gr = D1::golden_ratio_minimize(fv, bounds, p.golden_tol,
+                static_cast<std::size_t>(std::max(steps, 0.)) + 1);
+            const rv value = fv(gr.second);
+            if(!(value < value0)) return {false, {0., value0, 0.}};
+            return {gr.first, {gr.second, value, 0.}};
+        };
+
+        template<typename Func>
+        std::pair<bool, line_search::point> search_along(
+                const direction_function<Func>& phi, const rv value0,
+                const rv slope0, const rv alpha0, const params& p){
+            if(p.line == search::golden)
+                return golden_search(phi, value0, alpha0, p);
+            return line_search::wolfe_search(phi, value0, slope0, alpha0, p.wolfe);
+        };
+
+        // policy counts evaluations, times the gradient and line search
+        // phases and sees an event per step. Iterations use only ws; the
+        // iterate returned in the result is the one allocation per run.
+        template<typename Func, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        min_result_nd steepest_descent(const Func& f, const vec& x0, workspace& ws, const params& p = {},
+                Policy&& policy = Policy()){
+            using instrument::phase;
+            const auto fc = instrument::counted(f, policy);
+            if(ws.dim() != x0.size()) throw std::length_error("Workspace should match problem size");
+            vec x(x0), &d = ws.d, &g = ws.gn;
+            rv value = instrument::timed(policy, phase::gradient,
+                [&]{ return derivate::value_and_grad(fc, x, g, p.h); });
+            rv alpha = 1. / std::max(norm(g), 1.), prev_slope = 0.;
+            for(std::size_t step = 0; step < p.max_steps; step++){
+                if(norm(g) < p.tol) return {true, x, value, step};
+                std::transform(g.cbegin(), g.cend(), d.begin(), std::negate<rv>());
+                const rv slope = dot(g, d);
+                if(step > 0) alpha = std::min(1., alpha * prev_slope / slope);
+                const direction_function<decltype(fc)> phi(fc, x, d, p.h, ws);
+                const auto ls = instrument::timed(policy, phase::line_search,
+                    [&]{ return search_along(phi, value, slope, alpha, p); });
+                if(!(ls.second.alpha > 0.)) return {false, x, value, step};
+                instrument::timed(policy, phase::gradient,
+                    [&]{ phi.gradient_at(ls.second.alpha, g); });
+                const vec& xn = phi.trial(ls.second.alpha);
+                std::copy(xn.cbegin(), xn.cend(), x.begin());
+                value = ls.second.value;
+                alpha = ls.second.alpha;
+                prev_slope = slope;
+                policy.iteration({step + 1, value, norm(g), x.data()});
             };
-            return {false, 0};
+            return {norm(g) < p.tol, x, value, p.max_steps};
+        };
+
+        template<typename Func, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        min_result_nd steepest_descent(const Func& f, const vec& x0, const params& p = {},
+                Policy&& policy = Policy()){
+            workspace ws(x0.size());
+            return steepest_descent(f, x0, ws, p, policy);
+        };
+
+        // Inverse Hessian approximation is stored row-major in h; hy is
+        // scratch of length n
+        inline void bfgs_update(vec& h, const vec& s, const vec& y, vec& hy){
+            const std::size_t n = s.size();
+            const rv sy = dot(s, y);
+            if(!(sy > 0.)) return;
+            std::fill(hy.begin(), hy.end(), 0.);
+            for(std::size_t i = 0; i < n; i++)
+                for(std::size_t j = 0; j < n; j++)
+                    hy[i] += h[i * n + j] * y[j];
+            const rv yhy = dot(y, hy);
+            const rv a = (sy + yhy) / (sy * sy);
+            for(std::size_t i = 0; i < n; i++)
+                for(std::size_t j = 0; j < n; j++)
+                    h[i * n + j] += a * s[i] * s[j] - (hy[i] * s[j] + s[i] * hy[j]) / sy;
+        };
+
+        inline void bfgs_update(vec& h, const vec& s, const vec& y){
+            vec hy(s.size());
+            bfgs_update(h, s, y, hy);
         };
+
+        // Iterate, gradient and row-major inverse Hessian approximation
+        struct bfgs_state{
+            vec x, g, h;
+            rv value;
+            std::size_t step;
+        };
+
+        inline bool is_identity(const vec& h, const std::size_t n){
+            for(std::size_t i = 0; i < n; i++)
+                for(std::size_t j = 0; j < n; j++)
+                    if(h[i * n + j] != ((i == j) ? 1. : 0.)) return false;
+            return true;
+        };
+
+        template<typename Func, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        bfgs_state bfgs_start(const Func& f, const vec& x0, const params& p = {},
+                Policy&& policy = Policy()){
+            const std::size_t n = x0.size();
+            bfgs_state s{x0, vec(n), vec(n * n, 0.), 0., 0};
+            s.value = instrument::timed(policy, instrument::phase::gradient,
+                [&]{ return derivate::value_and_grad(instrument::counted(f, policy), s.x, s.g, p.h); });
+            for(std::size_t i = 0; i < n; i++) s.h[i * n + i] = 1.;
+            return s;
+        };
+
+        // Warm start for a changed objective: keeps the iterate and inverse
+        // Hessian of prev, refreshes value and gradient, restarts the count
         template<typename Func>
-        rv auto_golden_ratio_minimize(
-                const Func& f, 
-                const std::pair<rv, rv> bounds, 
-                const rv tol,
-                const std::size_t max_steps){
-            const auto h = bounds.second
+        bfgs_state bfgs_restart(const Func& f, bfgs_state prev, const params& p = {}){
+            prev.value = derivate::value_and_grad(f, prev.x, prev.g, p.h);
+            prev.step = 0;
+            return prev;
+        };
+
+        // Continues from st; observer(st) is called after every step. The
+        // initial step and curvature scaling apply only to a cold (identity)
+        // inverse Hessian. The direction and inverse Hessian update are
+        // timed as policy's linear_algebra phase.
+        template<typename Func, typename Observer, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        min_result_nd bfgs_run(const Func& f, bfgs_state& st, workspace& ws, const params& p,
+                Observer&& observer, Policy&& policy = Policy()){
+            using instrument::phase;
+            const auto fc = instrument::counted(f, policy);
+            const std::size_t n = st.x.size();
+            if(ws.dim() != n) throw std::length_error("Workspace should match problem size");
+            vec& x = st.x;
+            vec& g = st.g;
+            vec& h = st.h;
+            vec &d = ws.d, &s = ws.s, &y = ws.y, &gn = ws.gn;
+            const bool cold = (st.step == 0) && is_identity(h, n);
+            while(st.step < p.max_steps){
+                const std::size_t step = st.step;
+                if(norm(g) < p.tol) return {true, x, st.value, step};
+                instrument::timed(policy, phase::linear_algebra, [&]{
+                    for(std::size_t i = 0; i < n; i++)
+                        d[i] = - std::inner_product(g.cbegin(), g.cend(), h.cbegin() + i * n, 0.);
+                });
+                rv slope = dot(g, d);
+                if(!(slope < 0.)){
+                    std::fill(h.begin(), h.end(), 0.);
+                    for(std::size_t i = 0; i < n; i++) h[i * n + i] = 1.;
+                    std::transform(g.cbegin(), g.cend(), d.begin(), std::negate<rv>());
+                    slope = dot(g, d);
+                };
+                const rv alpha = (cold && (step == 0)) ? std::min(1., 1. / norm(g)) : 1.;
+                const direction_function<decltype(fc)> phi(fc, x, d, p.h, ws);
+                const auto ls = instrument::timed(policy, phase::line_search,
+                    [&]{ return search_along(phi, st.value, slope, alpha, p); });
+                if(!(ls.second.alpha > 0.)) return {false, x, st.value, step};
+                instrument::timed(policy, phase::gradient,
+                    [&]{ phi.gradient_at(ls.second.alpha, gn); });
+                const vec& xn = phi.trial(ls.second.alpha);
+                for(std::size_t i = 0; i < n; i++){
+                    s[i] = xn[i] - x[i];
+                    y[i] = gn[i] - g[i];
+                };
+                if(cold && (step == 0)){
+                    const rv yy = dot(y, y);
+                    if(yy > 0.){
+                        const rv scale = dot(s, y) / yy;
+                        if(scale > 0.)
+                            for(std::size_t i = 0; i < n; i++) h[i * n + i] = scale;
+                    };
+                };
+                instrument::timed(policy, phase::linear_algebra, [&]{ bfgs_update(h, s, y, ws.hy); });
+                std::copy(xn.cbegin(), xn.cend(), x.begin());
+                std::swap(g, gn);
+                st.value = ls.second.value;
+                st.step++;
+                observer(static_cast<const bfgs_state&>(st));
+                policy.iteration({st.step, st.value, norm(g), x.data()});
+            };
+            return {norm(g) < p.tol, x, st.value, p.max_steps};
+        };
+
+        template<typename Func, typename Observer, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        min_result_nd bfgs_run(const Func& f, bfgs_state& st, const params& p, Observer&& observer,
+                Policy&& policy = Policy()){
+            workspace ws(st.x.size());
+            return bfgs_run(f, st, ws, p, observer, policy);
+        };
+
+        template<typename Func, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        min_result_nd bfgs_minimize(const Func& f, const vec& x0, const params& p = {},
+                Policy&& policy = Policy()){
+            bfgs_state st = bfgs_start(f, x0, p, policy);
+            return bfgs_run(f, st, p, [](const bfgs_state&){}, policy);
+        };
+
+        // Runs from st and leaves the final state there for a later restart
+        template<typename Func, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        min_result_nd bfgs_minimize(const Func& f, bfgs_state& st, const params& p = {},
+                Policy&& policy = Policy()){
+            return bfgs_run(f, st, p, [](const bfgs_state&){}, policy);
+        };
+
+        // As above with a caller-owned workspace; repeated runs of one
+        // dimension then allocate only for the returned result
+        template<typename Func, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        min_result_nd bfgs_minimize(const Func& f, bfgs_state& st, workspace& ws,
+                const params& p = {}, Policy&& policy = Policy()){
+            return bfgs_run(f, st, ws, p, [](const bfgs_state&){}, policy);
         };
     };
 };
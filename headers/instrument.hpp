@@ -0,0 +1,185 @@
+#ifndef INSTRUMENT
+#define INSTRUMENT
+
+#include <array>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace minimize{
+    namespace instrument{
+        using rv = double;
+
+        enum class phase : std::size_t{
+            gradient = 0,
+            line_search = 1,
+            linear_algebra = 2
+        };
+
+        constexpr std::size_t phase_count = 3;
+
+        // One completed iteration; progress is the bracket width for
+        // one-dimensional searches and the gradient norm otherwise. x is
+        // the current iterate, valid only during the callback.
+        struct event{
+            std::size_t step;
+            rv value, progress;
+            const rv* x = nullptr;
+        };
+
+        // Policies provide evaluation(), begin(phase), end(phase) and
+        // iteration(event). This one does nothing and is the default
+        // everywhere, so uninstrumented code is unchanged after inlining.
+        struct none{
+            void evaluation(void){};
+            void begin(const phase){};
+            void end(const phase){};
+            void iteration(const event&){};
+        };
+
+        template<typename Policy, typename = void>
+        struct is_policy : std::false_type{};
+
+        template<typename Policy>
+        struct is_policy<Policy, std::void_t<decltype(
+            std::declval<Policy&>().iteration(std::declval<const event&>()))> > : std::true_type{};
+
+        template<typename Policy>
+        using enable_policy = std::enable_if_t<is_policy<std::remove_reference_t<Policy> >::value>;
+
+        // Times the enclosing block as one phase
+        template<typename Policy>
+        class scope{
+            protected:
+                Policy& _policy;
+                const phase _phase;
+            public:
+                scope(Policy& policy, const phase ph): _policy(policy), _phase(ph){
+                    _policy.begin(_phase);
+                };
+                scope(const scope&) = delete;
+                scope& operator=(const scope&) = delete;
+                ~scope(){
+                    _policy.end(_phase);
+                };
+        };
+
+        template<typename Policy, typename Body>
+        decltype(auto) timed(Policy& policy, const phase ph, Body&& body){
+            const scope<Policy> s(policy, ph);
+            return body();
+        };
+
+        // Objective wrapper reporting every call to the policy; an
+        // analytic value_and_gradient is forwarded and counts once
+        template<typename Func, typename Policy>
+        class counting{
+            protected:
+                const Func& _func;
+                Policy& _policy;
+            public:
+                counting(const Func& func, Policy& policy): _func(func), _policy(policy) {};
+                template<typename Arg>
+                auto operator()(const Arg& x) const{
+                    _policy.evaluation();
+                    return _func(x);
+                };
+                template<typename F = Func>
+                auto value_and_gradient(const std::vector<rv>& x, std::vector<rv>& g) const
+                        -> decltype(std::declval<const F&>().value_and_gradient(x, g)){
+                    _policy.evaluation();
+                    return _func.value_and_gradient(x, g);
+                };
+        };
+
+        template<typename Func, typename Policy>
+        counting<Func, Policy> counted(const Func& func, Policy& policy){
+            return counting<Func, Policy>(func, policy);
+        };
+
+        // Tick sources for recorder: nanoseconds of steady_clock, or the
+        // time stamp counter where the target has one
+        struct steady_ticks{
+            static std::uint64_t now(void){
+                return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+            };
+        };
+
+#if defined(__x86_64__) || defined(__i386__)
+        struct tsc_ticks{
+            static std::uint64_t now(void){
+                return __rdtsc();
+            };
+        };
+#endif
+
+        // Counts evaluations, accumulates ticks per phase and hands every
+        // event to callback. Nested scopes of one phase are timed once.
+        // Not synchronized: meant for single-threaded solvers.
+        template<typename Callback, typename Clock = steady_ticks>
+        class recorder{
+            protected:
+                Callback _callback;
+                std::size_t _evaluations;
+                std::array<std::uint64_t, phase_count> _ticks, _started;
+                std::array<std::size_t, phase_count> _calls, _depth;
+            public:
+                explicit recorder(Callback callback = Callback()):
+                    _callback(std::move(callback))
+                    {
+                        reset();
+                    };
+                void reset(void){
+                    _evaluations = 0;
+                    _ticks.fill(0);
+                    _started.fill(0);
+                    _calls.fill(0);
+                    _depth.fill(0);
+                };
+                void evaluation(void){
+                    _evaluations++;
+                };
+                void begin(const phase ph){
+                    const std::size_t i = static_cast<std::size_t>(ph);
+                    if(_depth[i]++ == 0) _started[i] = Clock::now();
+                };
+                void end(const phase ph){
+                    const std::size_t i = static_cast<std::size_t>(ph);
+                    if(--_depth[i] == 0){
+                        _ticks[i] += Clock::now() - _started[i];
+                        _calls[i]++;
+                    };
+                };
+                void iteration(const event& e){
+                    _callback(e);
+                };
+                std::size_t evaluations(void) const{
+                    return _evaluations;
+                };
+                std::uint64_t ticks(const phase ph) const{
+                    return _ticks[static_cast<std::size_t>(ph)];
+                };
+                std::size_t calls(const phase ph) const{
+                    return _calls[static_cast<std::size_t>(ph)];
+                };
+        };
+
+        struct ignore_events{
+            void operator()(const event&) const{};
+        };
+
+        template<typename Callback>
+        recorder<Callback> make_recorder(Callback callback){
+            return recorder<Callback>(std::move(callback));
+        };
+    };
+};
+
+#endif
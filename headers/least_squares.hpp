@@ -0,0 +1,192 @@
+#ifndef LEAST_SQUARES
+#define LEAST_SQUARES
+
+#include <vector>
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <parallel.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace least_squares{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        // Residual functors are called as f(x_range, out) and write
+        // m residuals into out[0], ..., out[m - 1]
+        struct params{
+            rv gtol = 1.e-10;
+            rv xtol = 1.e-12;
+            std::size_t max_steps = 512;
+            rv tau = 1.e-3;
+            // Accepted steps between Jacobian recomputations, with Broyden
+            // updates in between; 0 recomputes only after a rejected step
+            std::size_t refresh = 8;
+            std::size_t threads = 1;
+        };
+
+        struct workspace{
+            const std::size_t m, n;
+            vec r, rn, jac, jtj, jtr, delta, xn, ds, chol, y;
+            workspace(const std::size_t res, const std::size_t dim):
+                m(res), n(dim),
+                r(res), rn(res), jac(res * dim),
+                jtj(dim * dim), jtr(dim), delta(dim), xn(dim), ds(dim),
+                chol(dim * dim), y(dim)
+                {};
+        };
+
+        inline rv squares(const vec& r){
+            return std::inner_product(r.cbegin(), r.cend(), r.cbegin(), 0.);
+        };
+
+        // Column-major Jacobian: column j is built from a single
+        // subs_range perturbation of x along axis j
+        template<typename Func>
+        void jacobian(const Func& f, const vec& x, workspace& ws, const std::size_t threads){
+            const auto xr = ranges::const_range(x);
+            const rv eps = std::sqrt(std::numeric_limits<rv>::epsilon());
+            parallel::parallel_for(ws.n, threads, [&](const std::size_t j){
+                const rv h = eps * std::max(std::abs(x[j]), 1.);
+                const auto col = ws.jac.begin() + j * ws.m;
+                f(derivate::shifted_x(xr, j, h), col);
+                for(std::size_t i = 0; i < ws.m; i++) col[i] = (col[i] - ws.r[i]) / h;
+            });
+        };
+
+        // Broyden rank-1 update J += (dr - J s) s^T / (s^T s)
+        inline void broyden_update(workspace& ws){
+            const rv ss = std::inner_product(ws.delta.cbegin(), ws.delta.cend(), ws.delta.cbegin(), 0.);
+            if(!(ss > 0.)) return;
+            for(std::size_t i = 0; i < ws.m; i++){
+                rv js = 0.;
+                for(std::size_t j = 0; j < ws.n; j++) js += ws.jac[j * ws.m + i] * ws.delta[j];
+                const rv u = (ws.rn[i] - ws.r[i] - js) / ss;
+                for(std::size_t j = 0; j < ws.n; j++) ws.jac[j * ws.m + i] += u * ws.delta[j];
+            };
+        };
+
+        inline void normal_equations(workspace& ws){
+            const std::size_t m = ws.m, n = ws.n;
+            for(std::size_t i = 0; i < n; i++){
+                const auto ci = ws.jac.cbegin() + i * m;
+                ws.jtr[i] = std::inner_product(ci, ci + m, ws.r.cbegin(), 0.);
+                for(std::size_t j = 0; j <= i; j++){
+                    const auto cj = ws.jac.cbegin() + j * m;
+                    ws.jtj[i * n + j] = ws.jtj[j * n + i] = std::inner_product(ci, ci + m, cj, 0.);
+                };
+            };
+        };
+
+        // Solves (J^T J + lambda D) delta = - J^T r by Cholesky; D = diag(J^T J)
+        inline bool damped_solve(workspace& ws, const rv lambda){
+            const std::size_t n = ws.n;
+            vec& l = ws.y;
+            vec& a = ws.chol;
+            std::copy(ws.jtj.cbegin(), ws.jtj.cend(), a.begin());
+            for(std::size_t i = 0; i < n; i++){
+                ws.ds[i] = std::max(ws.jtj[i * n + i], std::numeric_limits<rv>::min());
+                a[i * n + i] += lambda * ws.ds[i];
+            };
+            for(std::size_t j = 0; j < n; j++){
+                rv d = a[j * n + j];
+                for(std::size_t k = 0; k < j; k++) d -= a[j * n + k] * a[j * n + k];
+                if(!(d > 0.)) return false;
+                a[j * n + j] = std::sqrt(d);
+                for(std::size_t i = j + 1; i < n; i++){
+                    rv s = a[i * n + j];
+                    for(std::size_t k = 0; k < j; k++) s -= a[i * n + k] * a[j * n + k];
+                    a[i * n + j] = s / a[j * n + j];
+                };
+            };
+            for(std::size_t i = 0; i < n; i++){
+                rv s = - ws.jtr[i];
+                for(std::size_t k = 0; k < i; k++) s -= a[i * n + k] * l[k];
+                l[i] = s / a[i * n + i];
+            };
+            for(std::size_t i = n; i-- > 0;){
+                rv s = l[i];
+                for(std::size_t k = i + 1; k < n; k++) s -= a[k * n + i] * ws.delta[k];
+                ws.delta[i] = s / a[i * n + i];
+            };
+            return true;
+        };
+
+        template<typename Func>
+        grad::min_result_nd lm_minimize(const Func& f, const std::size_t m,
+                const vec& x0, workspace& ws, const params& p = {}){
+            const std::size_t n = x0.size();
+            if((ws.m != m) || (ws.n != n))
+                throw std::length_error("Workspace should match problem size");
+            vec x(x0);
+            f(ranges::const_range(x), ws.r.begin());
+            rv cost = squares(ws.r);
+            jacobian(f, x, ws, p.threads);
+            normal_equations(ws);
+            rv lambda = 0., nu = 2.;
+            for(std::size_t i = 0; i < n; i++) lambda = std::max(lambda, ws.jtj[i * n + i]);
+            lambda *= p.tau;
+            std::size_t accepted = 0;
+            for(std::size_t step = 0; step < p.max_steps; step++){
+                rv gmax = 0.;
+                for(std::size_t i = 0; i < n; i++) gmax = std::max(gmax, std::abs(ws.jtr[i]));
+                if(gmax < p.gtol) return {true, x, cost, step};
+                if(!damped_solve(ws, lambda)){
+                    lambda *= nu; nu *= 2.;
+                    continue;
+                };
+                const rv dn = grad::norm(ws.delta), xnorm = grad::norm(x);
+                if(dn <= p.xtol * (xnorm + p.xtol)) return {true, x, cost, step};
+                for(std::size_t i = 0; i < n; i++) ws.xn[i] = x[i] + ws.delta[i];
+                f(ranges::const_range(ws.xn), ws.rn.begin());
+                const rv cost_n = squares(ws.rn);
+                rv pred = 0.;
+                for(std::size_t i = 0; i < n; i++)
+                    pred += ws.delta[i] * (lambda * ws.ds[i] * ws.delta[i] - ws.jtr[i]);
+                const rv rho = (pred > 0.) ? (cost - cost_n) / pred : -1.;
+                if(rho > 0.){
+                    std::copy(ws.xn.cbegin(), ws.xn.cend(), x.begin());
+                    accepted++;
+                    if((p.refresh > 0) && (accepted % p.refresh == 0)){
+                        std::swap(ws.r, ws.rn);
+                        jacobian(f, x, ws, p.threads);
+                    }else{
+                        broyden_update(ws);
+                        std::swap(ws.r, ws.rn);
+                    };
+                    cost = cost_n;
+                    const rv t = 2. * rho - 1.;
+                    lambda *= std::max(1. / 3., 1. - t * t * t);
+                    nu = 2.;
+                    normal_equations(ws);
+                }else{
+                    // Retry from a fresh Jacobian unless it already is one
+                    const bool stale = (p.refresh > 0) ? (accepted % p.refresh != 0) : (accepted != 0);
+                    if(stale){
+                        jacobian(f, x, ws, p.threads);
+                        normal_equations(ws);
+                        accepted = 0;
+                    };
+                    lambda *= nu; nu *= 2.;
+                };
+            };
+            return {false, x, cost, p.max_steps};
+        };
+
+        template<typename Func>
+        grad::min_result_nd lm_minimize(const Func& f, const std::size_t m,
+                const vec& x0, const params& p = {}){
+            workspace ws(m, x0.size());
+            return lm_minimize(f, m, x0, ws, p);
+        };
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,113 @@
+#ifndef LINE_SEARCH
+#define LINE_SEARCH
+
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+namespace minimize{
+    namespace line_search{
+        using rv = double;
+
+        struct wolfe_params{
+            rv c1 = 1.e-4;
+            rv c2 = 0.9;
+            rv alpha_max = 1.e+8;
+            std::size_t max_steps = 32;
+        };
+
+        // Sample of phi(alpha) = f(x + alpha * d) with its slope
+        struct point{
+            rv alpha;
+            rv value;
+            rv slope;
+        };
+
+        inline rv bisect(const point& a, const point& b){
+            return 0.5 * (a.alpha + b.alpha);
+        };
+
+        inline rv quadratic_min(const point& a, const point& b){
+            const rv dx = b.alpha - a.alpha;
+            const rv den = 2. * (b.value - a.value - a.slope * dx);
+            if(den <= 0.) return bisect(a, b);
+            return a.alpha - a.slope * dx * dx / den;
+        };
+
+        inline rv cubic_min(const point& a, const point& b){
+            const rv dx = b.alpha - a.alpha;
+            const rv d1 = a.slope + b.slope - 3. * (b.value - a.value) / dx;
+            const rv disc = d1 * d1 - a.slope * b.slope;
+            if(disc < 0.) return quadratic_min(a, b);
+            const rv d2 = std::copysign(std::sqrt(disc), dx);
+            const rv den = b.slope - a.slope + 2. * d2;
+            if(den == 0.) return quadratic_min(a, b);
+            return b.alpha - dx * (b.slope + d2 - d1) / den;
+        };
+
+        // Keeps the trial step away from the interval ends
+        inline rv safeguarded(const point& a, const point& b, const rv alpha){
+            const rv lo = std::min(a.alpha, b.alpha),
+                     hi = std::max(a.alpha, b.alpha);
+            const rv margin = 0.1 * (hi - lo);
+            if(!std::isfinite(alpha) || (alpha < lo + margin) || (alpha > hi - margin))
+                return bisect(a, b);
+            return alpha;
+        };
+
+        template<typename Phi>
+        std::pair<bool, point> zoom(const Phi& phi, const point& p0,
+                point lo, point hi, const wolfe_params& p){
+            const rv eps = std::numeric_limits<rv>::epsilon();
+            for(std::size_t step = 0; step < p.max_steps; step++){
+                const rv alpha = safeguarded(lo, hi, cubic_min(lo, hi));
+                const auto ev = phi(alpha);
+                const point cur{alpha, ev.first, ev.second};
+                const bool armijo = cur.value <= p0.value + p.c1 * alpha * p0.slope;
+                if(!armijo || (cur.value >= lo.value)){
+                    hi = cur;
+                }else{
+                    if(std::abs(cur.slope) <= - p.c2 * p0.slope)
+                        return {true, cur};
+                    if(cur.slope * (hi.alpha - lo.alpha) >= 0.)
+                        hi = lo;
+                    lo = cur;
+                };
+                if(std::abs(hi.alpha - lo.alpha) <= eps * std::max(1., lo.alpha))
+                    break;
+            };
+            return {false, lo};
+        };
+
+        // Strong-Wolfe search (Nocedal & Wright, alg. 3.5/3.6) with
+        // cubic interpolation; phi(alpha) returns {value, slope}
+        template<typename Phi>
+        std::pair<bool, point> wolfe_search(const Phi& phi,
+                const rv value0, const rv slope0,
+                const rv alpha0 = 1., const wolfe_params& p = {}){
+            const point p0{0., value0, slope0};
+            if(!(slope0 < 0.)) return {false, p0};
+            point prev = p0;
+            rv alpha = std::min(alpha0, p.alpha_max);
+            for(std::size_t step = 0; step < p.max_steps; step++){
+                const auto ev = phi(alpha);
+                const point cur{alpha, ev.first, ev.second};
+                const bool armijo = cur.value <= value0 + p.c1 * alpha * slope0;
+                if(!armijo || ((step > 0) && (cur.value >= prev.value)))
+                    return zoom(phi, p0, prev, cur, p);
+                if(std::abs(cur.slope) <= - p.c2 * slope0)
+                    return {true, cur};
+                if(cur.slope >= 0.)
+                    return zoom(phi, p0, cur, prev, p);
+                if(alpha >= p.alpha_max)
+                    return {false, cur};
+                prev = cur;
+                alpha = std::min(4. * alpha, p.alpha_max);
+            };
+            return {false, prev};
+        };
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+#ifndef MAPPED
+#define MAPPED
+
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <ranges.hpp>
+
+namespace minimize{
+    namespace mapped{
+        enum class mode{
+            read_only,
+            read_write
+        };
+
+        // Vector of T stored in a file and mapped into memory, so large
+        // parameter blocks are read and written in place by the ranges
+        // and ops. Writes reach the file through the page cache; sync()
+        // forces them to disk and throws runtime_error if it cannot. Elements are raw bytes in host order.
+        template<typename T>
+        class mapped_vector{
+            static_assert(std::is_trivially_copyable<T>::value, "T should be trivially copyable");
+            public:
+                using value_type = T;
+                using reference = T&;
+                using const_reference = const T&;
+                using iterator = T*;
+                using const_iterator = const T*;
+            protected:
+                int _fd;
+                std::size_t _size;
+                void* _memory;
+                void map(const std::string& path, const int prot){
+                    if(_size == 0) return;
+                    _memory = mmap(nullptr, _size * sizeof(T), prot, MAP_SHARED, _fd, 0);
+                    if(_memory == MAP_FAILED){
+                        close(_fd);
+                        throw std::runtime_error("Cannot map " + path);
+                    };
+                };
+                void release(void){
+                    if(_memory != MAP_FAILED) munmap(_memory, _size * sizeof(T));
+                    if(_fd >= 0) close(_fd);
+                    _fd = -1;
+                    _memory = MAP_FAILED;
+                };
+            public:
+                // Creates path, or resizes an existing file, to size elements
+                mapped_vector(const std::string& path, const std::size_t size):
+                    _fd(open(path.c_str(), O_RDWR | O_CREAT, 0644)), _size(size), _memory(MAP_FAILED)
+                    {
+                        if(_fd < 0) throw std::runtime_error("Cannot open " + path);
+                        if(ftruncate(_fd, static_cast<off_t>(size * sizeof(T))) != 0){
+                            close(_fd);
+                            throw std::runtime_error("Cannot size " + path);
+                        };
+                        map(path, PROT_READ | PROT_WRITE);
+                    };
+                // Maps an existing file, whose length sets the size
+                explicit mapped_vector(const std::string& path, const mode m = mode::read_write):
+                    _fd(open(path.c_str(), (m == mode::read_only) ? O_RDONLY : O_RDWR)), _size(0), _memory(MAP_FAILED)
+                    {
+                        if(_fd < 0) throw std::runtime_error("Cannot open " + path);
+                        struct stat st;
+                        if(fstat(_fd, &st) != 0){
+                            close(_fd);
+                            throw std::runtime_error("Cannot stat " + path);
+                        };
+                        if(static_cast<std::size_t>(st.st_size) % sizeof(T) != 0){
+                            close(_fd);
+                            throw std::logic_error(path + " does not hold whole elements");
+                        };
+                        _size = static_cast<std::size_t>(st.st_size) / sizeof(T);
+                        map(path, (m == mode::read_only) ? PROT_READ : (PROT_READ | PROT_WRITE));
+                    };
+                mapped_vector(const mapped_vector<T>&) = delete;
+                mapped_vector<T>& operator=(const mapped_vector<T>&) = delete;
+                mapped_vector(mapped_vector<T>&& oth):
+                    _fd(std::exchange(oth._fd, -1)), _size(std::exchange(oth._size, 0)),
+                    _memory(std::exchange(oth._memory, MAP_FAILED))
+                    {};
+                mapped_vector<T>& operator=(mapped_vector<T>&& oth){
+                    if(this != &oth){
+                        release();
+                        _fd = std::exchange(oth._fd, -1);
+                        _size = std::exchange(oth._size, 0);
+                        _memory = std::exchange(oth._memory, MAP_FAILED);
+                    };
+                    return *this;
+                };
+                ~mapped_vector(){
+                    release();
+                };
+                std::size_t size(void) const{
+                    return _size;
+                };
+                T* data(void){
+                    return (_size == 0) ? nullptr : static_cast<T*>(_memory);
+                };
+                const T* data(void) const{
+                    return (_size == 0) ? nullptr : static_cast<const T*>(_memory);
+                };
+                reference operator[](const std::size_t i){
+                    return data()[i];
+                };
+                const_reference operator[](const std::size_t i) const{
+                    return data()[i];
+                };
+                reference at(const std::size_t i){
+                    if(i >= _size) throw std::out_of_range("Index should be less than mapped_vector size");
+                    return data()[i];
+                };
+                const_reference at(const std::size_t i) const{
+                    if(i >= _size) throw std::out_of_range("Index should be less than mapped_vector size");
+                    return data()[i];
+                };
+                iterator begin(void){
+                    return data();
+                };
+                iterator end(void){
+                    return data() + _size;
+                };
+                const_iterator begin(void) const{
+                    return data();
+                };
+                const_iterator end(void) const{
+                    return data() + _size;
+                };
+                const_iterator cbegin(void) const{
+                    return data();
+                };
+                const_iterator cend(void) const{
+                    return data() + _size;
+                };
+                // Read-only range over the mapping, valid while it lives
+                ranges::const_range<ranges::span<T> > view(void) const{
+                    return ranges::span_range(data(), _size);
+                };
+                void sync(void) const{
+                    if((_memory != MAP_FAILED) && (msync(_memory, _size * sizeof(T), MS_SYNC) != 0))
+                        throw std::runtime_error("Cannot sync mapping to its file");
+                };
+        };
+    };
+
+    namespace ranges{
+        template<typename T>
+        struct contiguous<mapped::mapped_vector<T> > : std::true_type{};
+    };
+};
+
+#endif
@@ -5,55 +5,197 @@
 #define SPHI 0.381966011250105151795413165634361882279690820194237137864
 
 #include <cmath>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
 
 #include <ranges.hpp>
 #include <operations.hpp>
+#include <instrument.hpp>
 
 namespace minimize{
     namespace D1{
         using rv = double;
-        template<typename Func>
-        std::pair<bool, rv> golden_ratio_minimize(
-                const Func& f, 
-                const std::pair<rv, rv>& bounds, 
-                const rv& tol,
-                const std::size_t& max_steps){
-            rv a = std::min(bounds.first, bounds.second), 
-               b = std::max(bounds.first, bounds.second);
-            rv h = b - a;
-            rv c, d, vc, vd;
-            {
-                c = a + h * SPHI, d = a + h * FPHI;
-                vc = f(c), vd = f(d);
-            };
-            for(std::size_t step = 0; (step < max_steps) && (tol < h); step++){
-                if(vc < vd){
-                    b = d; d = c;
-                    vd = vc;
-                    h = h * FPHI;
-                    c = a + h * SPHI;
-                    vc = f(c);
+        // Bracket [a, b] with interior points c < d and their cached values,
+        // all in the scalar type T of the search (float, double, long double)
+        template<typename T>
+        struct basic_golden_state{
+            T a, b, c, d, vc, vd, h;
+            std::size_t step;
+        };
+
+        using golden_state = basic_golden_state<rv>;
+
+        // Scalar type of a search over bounds of type T; integral bounds
+        // are searched in rv
+        template<typename T>
+        using real_t = std::conditional_t<std::is_floating_point<T>::value, T, rv>;
+
+        template<typename Func, typename T>
+        basic_golden_state<T> golden_start(const Func& f, const std::pair<T, T>& bounds){
+            basic_golden_state<T> s;
+            s.a = std::min(bounds.first, bounds.second);
+            s.b = std::max(bounds.first, bounds.second);
+            s.h = s.b - s.a;
+            s.c = s.a + s.h * static_cast<T>(SPHI), s.d = s.a + s.h * static_cast<T>(FPHI);
+            s.vc = f(s.c), s.vd = f(s.d);
+            s.step = 0;
+            return s;
+        };
+
+        // Continues from s; observer(s) is called after every step
+        template<typename Func, typename T, typename Observer>
+        std::pair<bool, T> golden_run(
+                const Func& f,
+                basic_golden_state<T>& s,
+                const T& tol,
+                const std::size_t& max_steps,
+                Observer&& observer){
+            const T fphi = static_cast<T>(FPHI), sphi = static_cast<T>(SPHI), half = static_cast<T>(0.5);
+            while((s.step < max_steps) && (tol < s.h)){
+                if(s.vc < s.vd){
+                    s.b = s.d; s.d = s.c;
+                    s.vd = s.vc;
+                    s.h = s.h * fphi;
+                    s.c = s.a + s.h * sphi;
+                    s.vc = f(s.c);
                 }else{
-                    a = c; c = d;
-                    vc = vd;
-                    h = h * FPHI;
-                    d = a + h * FPHI;
-                    vd = f(d);
+                    s.a = s.c; s.c = s.d;
+                    s.vc = s.vd;
+                    s.h = s.h * fphi;
+                    s.d = s.a + s.h * fphi;
+                    s.vd = f(s.d);
                 };
+                s.step++;
+                observer(static_cast<const basic_golden_state<T>&>(s));
+            };
+            if(s.vc < s.vd){
+                return {(tol > s.h), half * (s.a + s.d)};
+            }else{
+                return {(tol > s.h), half * (s.b + s.c)};
+            };
+        };
+
+        // Runs s to completion through the counted objective fc, with one
+        // policy event per step
+        template<typename Func, typename T, typename Policy>
+        std::pair<bool, T> observed_golden_run(
+                const Func& fc,
+                basic_golden_state<T>& s,
+                const T& tol,
+                const std::size_t& max_steps,
+                Policy& policy){
+            return golden_run(fc, s, tol, max_steps, [&policy](const basic_golden_state<T>& st){
+                const bool left = st.vc < st.vd;
+                const rv* x = nullptr;
+                if constexpr(std::is_same<T, rv>::value) x = left ? &st.c : &st.d;
+                policy.iteration({st.step, static_cast<rv>(left ? st.vc : st.vd), static_cast<rv>(st.h), x});
+            });
+        };
+
+        // policy sees every evaluation, the search as one line_search
+        // phase and an event per step. The scalar type follows bounds
+        // (rv when braced); events carry the iterate only for double
+        // searches.
+        template<typename Func, typename T = rv, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        std::pair<bool, real_t<T> > golden_ratio_minimize(
+                const Func& f, 
+                const std::pair<T, T>& bounds, 
+                const real_t<T>& tol,
+                const std::size_t& max_steps,
+                Policy&& policy = Policy()){
+            using S = real_t<T>;
+            const instrument::scope<std::remove_reference_t<Policy> > timed(policy, instrument::phase::line_search);
+            const auto fc = instrument::counted(f, policy);
+            basic_golden_state<S> s = golden_start(fc, std::pair<S, S>(bounds));
+            return observed_golden_run(fc, s, tol, max_steps, policy);
+        };
+
+        // Previous optimum and a bracket half-width expected to contain
+        // the new one
+        struct warm_start{
+            rv x, radius;
+        };
+
+        // Golden-section state for a bracket grown around warm.x. The first
+        // bracket is 2 radius wide with warm.x at its left golden point; it
+        // grows by the golden ratio (within bounds) while the minimum lies
+        // beyond either end, which keeps the best point at a golden point
+        // of the bracket. That point and its value become an interior point
+        // of the state, so only the other one is evaluated. A bracket cut
+        // by bounds has no such point and is sectioned afresh.
+        template<typename Func, typename T>
+        basic_golden_state<T> warm_bracket(
+                const Func& f,
+                const std::pair<T, T>& bounds,
+                const warm_start& warm){
+            const T lower = std::min(bounds.first, bounds.second),
+                    upper = std::max(bounds.first, bounds.second);
+            const T sphi = static_cast<T>(SPHI), fphi = static_cast<T>(FPHI), grow = fphi / sphi;
+            const T width = static_cast<T>(2. * warm.radius);
+            T x = std::clamp(static_cast<T>(warm.x), lower, upper);
+            T lo = std::max(lower, x - sphi * width), hi = std::min(upper, x + fphi * width);
+            // Whether x sits at the left (c) or right (d) golden point
+            bool at_c = (lo == x - sphi * width) && (hi == x + fphi * width), at_d = false;
+            auto fl = f(lo), fm = f(x), fh = f(hi);
+            while((fl < fm) && (lo > lower)){
+                hi = x; fh = fm;
+                x = lo; fm = fl;
+                const T next = x - grow * (hi - x);
+                lo = std::max(lower, next);
+                at_c = false;
+                at_d = (lo == next);
+                fl = f(lo);
+            };
+            while((fh < fm) && (hi < upper)){
+                lo = x; fl = fm;
+                x = hi; fm = fh;
+                const T next = x + grow * (x - lo);
+                hi = std::min(upper, next);
+                at_c = (hi == next);
+                at_d = false;
+                fh = f(hi);
             };
-            if(vc < vd){
-                return {(tol > h), 0.5 * (a + d)};
+            if(!at_c && !at_d) return golden_start(f, std::pair<T, T>(lo, hi));
+            basic_golden_state<T> s;
+            s.a = lo;
+            s.b = hi;
+            s.h = hi - lo;
+            s.step = 0;
+            if(at_c){
+                s.c = x; s.vc = fm;
+                s.d = lo + s.h * fphi; s.vd = f(s.d);
             }else{
-                return {(tol > h), 0.5 * (b + c)};
+                s.d = x; s.vd = fm;
+                s.c = lo + s.h * sphi; s.vc = f(s.c);
             };
-            return {false, 0};
+            return s;
+        };
+
+        // The bracket evaluations count towards policy and are timed with
+        // the search as one line_search phase
+        template<typename Func, typename T = rv, typename Policy = instrument::none,
+            typename = instrument::enable_policy<Policy> >
+        std::pair<bool, real_t<T> > golden_ratio_minimize(
+                const Func& f, 
+                const std::pair<T, T>& bounds, 
+                const real_t<T>& tol,
+                const std::size_t& max_steps,
+                const warm_start& warm,
+                Policy&& policy = Policy()){
+            using S = real_t<T>;
+            const instrument::scope<std::remove_reference_t<Policy> > timed(policy, instrument::phase::line_search);
+            const auto fc = instrument::counted(f, policy);
+            basic_golden_state<S> s = warm_bracket(fc, std::pair<S, S>(bounds), warm);
+            return observed_golden_run(fc, s, tol, max_steps, policy);
         };
 
-        template<typename Func>
-        rv auto_golden_ratio_minimize(
+        template<typename Func, typename T = rv>
+        real_t<T> auto_golden_ratio_minimize(
                 const Func& f, 
-                const std::pair<rv, rv> bounds, 
-                const rv tol = 1.e-8){
+                const std::pair<T, T> bounds, 
+                const real_t<T> tol = static_cast<real_t<T> >(1.e-8)){
             const auto h = std::abs(bounds.second - bounds.first);
             const auto rvn = std::log(tol / h) / std::log(FPHI);
             const auto max_steps = static_cast<std::size_t>(rvn) + 1;
@@ -0,0 +1,174 @@
+#ifndef MULTISTART
+#define MULTISTART
+
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <cmath>
+#include <utility>
+#include <type_traits>
+#include <exception>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <sampling.hpp>
+#include <work_stealing.hpp>
+#include <grad_minimize.hpp>
+#include <box_minimize.hpp>
+
+namespace minimize{
+    namespace multistart{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        enum class starts{
+            sobol,
+            latin_hypercube
+        };
+
+        struct params{
+            std::size_t count = 64;
+            starts method = starts::sobol;
+            std::uint64_t seed = 0;
+            // Starts closer than radius * box diameter to a known minimum
+            // with a higher value are treated as lying in its basin
+            rv radius = 0.05;
+            // Once a value reaches target, queued starts are dropped and
+            // running searches stop at their next check; the default never
+            // stops early
+            rv target = - std::numeric_limits<rv>::infinity();
+            // BFGS steps between two checks of the stop condition
+            std::size_t check_every = 8;
+            std::size_t threads = parallel::hardware_threads();
+            grad::params local = {};
+        };
+
+        // screened counts the starts evaluated for the basin test, one
+        // objective value each on top of the local searches
+        struct multistart_result{
+            grad::min_result_nd best;
+            std::vector<grad::min_result_nd> minima;
+            std::size_t searches, skipped, screened;
+        };
+
+        // Lock-free running minimum shared by all local searches
+        inline bool update_min(std::atomic<rv>& best, const rv value){
+            rv cur = best.load();
+            while(value < cur)
+                if(best.compare_exchange_weak(cur, value)) return true;
+            return false;
+        };
+
+        inline vec start_points(const box::bounds& b, const params& p){
+            vec ret_val;
+            if(p.method == starts::sobol){
+                ret_val = sampling::sobol_points(p.count, b.dim());
+            }else{
+                std::mt19937_64 gen(p.seed);
+                ret_val = sampling::latin_hypercube(p.count, b.dim(), gen);
+            };
+            sampling::scale(ret_val, b.lower, b.upper);
+            return ret_val;
+        };
+
+        inline rv distance(const vec& a, const vec& b){
+            rv ret_val = 0.;
+            for(std::size_t j = 0; j < a.size(); j++) ret_val += (a[j] - b[j]) * (a[j] - b[j]);
+            return std::sqrt(ret_val);
+        };
+
+        // BFGS from x0 in slices of p.check_every steps, ending early once
+        // stop(value) holds for the current value
+        template<typename Func, typename Stop>
+        grad::min_result_nd stoppable_bfgs(const Func& f, const vec& x0, const params& p, const Stop& stop){
+            grad::bfgs_state st = grad::bfgs_start(f, x0, p.local);
+            grad::workspace ws(x0.size());
+            grad::params slice = p.local;
+            while(true){
+                if(stop(st.value)) return {false, st.x, st.value, st.step};
+                slice.max_steps = std::min(st.step + std::max<std::size_t>(p.check_every, 1), p.local.max_steps);
+                const grad::min_result_nd res = grad::bfgs_run(f, st, ws, slice, [](const grad::bfgs_state&){});
+                // Converged, failed, or out of steps for good
+                if(res.status || (res.steps < slice.max_steps) || (slice.max_steps == p.local.max_steps))
+                    return res;
+            };
+        };
+
+        // local(f, x0) runs one local search and returns grad::min_result_nd.
+        // A local also callable as local(f, x0, stop) is handed a predicate
+        // stop(value), true once value or any finished search reached
+        // p.target, and should poll it to end in-flight searches.
+        template<typename Func, typename Local>
+        multistart_result minimize_with(const Func& f, const box::bounds& b,
+                const Local& local, const params& p = {}){
+            const std::size_t n = b.dim();
+            const vec points = start_points(b, p);
+            rv diameter = 0.;
+            for(std::size_t j = 0; j < n; j++){
+                const rv w = b.upper[j] - b.lower[j];
+                diameter += w * w;
+            };
+            const rv radius = p.radius * std::sqrt(diameter);
+            std::atomic<rv> best{std::numeric_limits<rv>::infinity()};
+            std::atomic<std::size_t> searches{0}, skipped{0}, screened{0};
+            const auto stop = [&best, &p](const rv value){
+                return (value <= p.target) || (best.load() <= p.target);
+            };
+            std::mutex lock;
+            std::vector<grad::min_result_nd> minima;
+            const auto in_basin = [&](const vec& x, const rv value){
+                std::lock_guard<std::mutex> guard(lock);
+                for(const auto& m : minima)
+                    if((distance(x, m.x) < radius) && (value >= m.value)) return true;
+                return false;
+            };
+            parallel::work_stealing_pool pool(p.threads);
+            for(std::size_t i = 0; i < p.count; i++){
+                pool.push([&, i](const std::size_t){
+                    if(best.load() <= p.target){
+                        skipped++;
+                        return;
+                    };
+                    const vec x0(points.cbegin() + i * n, points.cbegin() + (i + 1) * n);
+                    screened++;
+                    if(in_basin(x0, f(ranges::const_range(x0)))){
+                        skipped++;
+                        return;
+                    };
+                    searches++;
+                    grad::min_result_nd res = [&]{
+                        if constexpr(std::is_invocable<const Local&, const Func&, const vec&, decltype(stop)>::value){
+                            return local(f, x0, stop);
+                        }else{
+                            return local(f, x0);
+                        };
+                    }();
+                    update_min(best, res.value);
+                    std::lock_guard<std::mutex> guard(lock);
+                    for(const auto& m : minima)
+                        if(distance(res.x, m.x) < radius) return;
+                    minima.push_back(std::move(res));
+                });
+            };
+            pool.run();
+            if(minima.empty())
+                throw std::logic_error("Multistart performed no local search");
+            std::sort(minima.begin(), minima.end(),
+                [](const auto& a, const auto& c){ return a.value < c.value; });
+            return {minima.front(), std::move(minima), searches.load(), skipped.load(), screened.load()};
+        };
+
+        template<typename Func>
+        multistart_result minimize(const Func& f, const box::bounds& b, const params& p = {}){
+            const auto local = [&p](const Func& fn, const vec& x0, const auto& stop){
+                return stoppable_bfgs(fn, x0, p, stop);
+            };
+            return minimize_with(f, b, local, p);
+        };
+    };
+};
+
+#endif
\ No newline at end of file
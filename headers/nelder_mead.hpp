@@ -0,0 +1,212 @@
+#ifndef NELDER_MEAD
+#define NELDER_MEAD
+
+#include <vector>
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <parallel.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace nelder_mead{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        struct params{
+            rv xtol = 1.e-8;
+            rv ftol = 1.e-10;
+            std::size_t max_steps = 100000;
+            rv step = 0.05;
+            rv zero_step = 2.5e-4;
+            bool adaptive = true;
+            std::size_t threads = 1;
+        };
+
+        struct coefficients{
+            rv reflection, expansion, contraction, shrink;
+        };
+
+        // Gao & Han adaptive coefficients, standard ones for adaptive = false
+        inline coefficients make_coefficients(const std::size_t n, const bool adaptive){
+            if(!adaptive || n < 2) return {1., 2., 0.5, 0.5};
+            const rv nd = static_cast<rv>(n);
+            return {1., 1. + 2. / nd, 0.75 - 0.5 / nd, 1. - 1. / nd};
+        };
+
+        // Simplex vertices are rows of one contiguous (n + 1) x n block
+        class simplex{
+            protected:
+                const std::size_t _dim;
+                vec _body, _values, _sum;
+            public:
+                simplex(const vec& x0, const params& p):
+                    _dim(x0.size()),
+                    _body((x0.size() + 1) * x0.size()),
+                    _values(x0.size() + 1),
+                    _sum(x0.size(), 0.)
+                    {
+                        for(std::size_t v = 0; v <= _dim; v++){
+                            std::copy(x0.cbegin(), x0.cend(), vertex(v));
+                            if(v == 0) continue;
+                            rv& c = vertex(v)[v - 1];
+                            c = (c != 0.) ? c * (1. + p.step) : p.zero_step;
+                        };
+                        update_sum();
+                    };
+                std::size_t dim(void) const{
+                    return _dim;
+                };
+                vec::iterator vertex(const std::size_t v){
+                    return _body.begin() + v * _dim;
+                };
+                vec::const_iterator vertex(const std::size_t v) const{
+                    return _body.cbegin() + v * _dim;
+                };
+                auto vertex_range(const std::size_t v) const{
+                    return ranges::const_range<vec>(vertex(v), vertex(v) + _dim);
+                };
+                rv& value(const std::size_t v){
+                    return _values[v];
+                };
+                rv value(const std::size_t v) const{
+                    return _values[v];
+                };
+                // Running vertex sum, kept incrementally between shrinks
+                vec& sum(void){
+                    return _sum;
+                };
+                const vec& sum(void) const{
+                    return _sum;
+                };
+                void update_sum(void){
+                    std::fill(_sum.begin(), _sum.end(), 0.);
+                    for(std::size_t v = 0; v <= _dim; v++){
+                        const auto it = vertex(v);
+                        for(std::size_t i = 0; i < _dim; i++) _sum[i] += it[i];
+                    };
+                };
+                // Centroid of all vertices except the one at w
+                void centroid(const std::size_t w, vec& out) const{
+                    const auto it = vertex(w);
+                    const rv nd = static_cast<rv>(_dim);
+                    for(std::size_t i = 0; i < _dim; i++) out[i] = (_sum[i] - it[i]) / nd;
+                };
+                void replace(const std::size_t v, const vec& x, const rv value){
+                    const auto it = vertex(v);
+                    for(std::size_t i = 0; i < _dim; i++){
+                        _sum[i] += x[i] - it[i];
+                        it[i] = x[i];
+                    };
+                    _values[v] = value;
+                };
+                rv spread(const std::size_t b) const{
+                    rv ret_val = 0.;
+                    const auto bt = vertex(b);
+                    for(std::size_t v = 0; v <= _dim; v++){
+                        const auto it = vertex(v);
+                        for(std::size_t i = 0; i < _dim; i++)
+                            ret_val = std::max(ret_val, std::abs(it[i] - bt[i]));
+                    };
+                    return ret_val;
+                };
+        };
+
+        struct order{
+            std::size_t best, worst, second;
+        };
+
+        inline order find_order(const simplex& s){
+            order ret_val{0, 0, 0};
+            for(std::size_t v = 1; v <= s.dim(); v++){
+                if(s.value(v) < s.value(ret_val.best)) ret_val.best = v;
+                if(s.value(v) >= s.value(ret_val.worst)) ret_val.worst = v;
+            };
+            ret_val.second = ret_val.best;
+            for(std::size_t v = 0; v <= s.dim(); v++){
+                if(v == ret_val.worst) continue;
+                if(s.value(v) >= s.value(ret_val.second)) ret_val.second = v;
+            };
+            return ret_val;
+        };
+
+        inline void affine(const vec& c, const rv t, const vec& x, vec& out){
+            for(std::size_t i = 0; i < c.size(); i++) out[i] = c[i] + t * (x[i] - c[i]);
+        };
+
+        template<typename Func>
+        void shrink(const Func& f, simplex& s, const std::size_t b,
+                const rv delta, const std::size_t threads){
+            const std::size_t n = s.dim();
+            const auto bt = s.vertex(b);
+            parallel::parallel_for(n + 1, threads, [&](const std::size_t v){
+                if(v == b) return;
+                const auto it = s.vertex(v);
+                for(std::size_t i = 0; i < n; i++) it[i] = bt[i] + delta * (it[i] - bt[i]);
+                s.value(v) = f(s.vertex_range(v));
+            });
+            s.update_sum();
+        };
+
+        // Continues from an evaluated simplex at step first; observer(s, step)
+        // is called after every step
+        template<typename Func, typename Observer>
+        grad::min_result_nd run(const Func& f, simplex& s, const std::size_t first,
+                const params& p, Observer&& observer){
+            const std::size_t n = s.dim();
+            const coefficients k = make_coefficients(n, p.adaptive);
+            vec c(n), xw(n), xr(n), xt(n);
+            for(std::size_t step = first; step < p.max_steps; step++){
+                const order o = find_order(s);
+                const auto bt = s.vertex(o.best);
+                if((s.value(o.worst) - s.value(o.best) <= p.ftol) && (s.spread(o.best) <= p.xtol))
+                    return {true, vec(bt, bt + n), s.value(o.best), step};
+                s.centroid(o.worst, c);
+                std::copy(s.vertex(o.worst), s.vertex(o.worst) + n, xw.begin());
+                affine(c, - k.reflection, xw, xr);
+                const rv fr = f(ranges::const_range(xr));
+                if(fr < s.value(o.best)){
+                    affine(c, k.expansion, xr, xt);
+                    const rv fe = f(ranges::const_range(xt));
+                    if(fe < fr) s.replace(o.worst, xt, fe);
+                    else s.replace(o.worst, xr, fr);
+                }else if(fr < s.value(o.second)){
+                    s.replace(o.worst, xr, fr);
+                }else if(fr < s.value(o.worst)){
+                    affine(c, k.contraction, xr, xt);
+                    const rv fc = f(ranges::const_range(xt));
+                    if(fc <= fr) s.replace(o.worst, xt, fc);
+                    else shrink(f, s, o.best, k.shrink, p.threads);
+                }else{
+                    affine(c, k.contraction, xw, xt);
+                    const rv fc = f(ranges::const_range(xt));
+                    if(fc < s.value(o.worst)) s.replace(o.worst, xt, fc);
+                    else shrink(f, s, o.best, k.shrink, p.threads);
+                };
+                observer(static_cast<const simplex&>(s), step + 1);
+            };
+            const order o = find_order(s);
+            const auto bt = s.vertex(o.best);
+            return {false, vec(bt, bt + n), s.value(o.best), p.max_steps};
+        };
+
+        template<typename Func>
+        void evaluate(const Func& f, simplex& s, const std::size_t threads){
+            parallel::parallel_for(s.dim() + 1, threads, [&](const std::size_t v){
+                s.value(v) = f(s.vertex_range(v));
+            });
+        };
+
+        template<typename Func>
+        grad::min_result_nd minimize(const Func& f, const vec& x0, const params& p = {}){
+            simplex s(x0, p);
+            evaluate(f, s, p.threads);
+            return run(f, s, 0, p, [](const simplex&, const std::size_t){});
+        };
+    };
+};
+
+#endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <exception>
 #include <algorithm>
 #include <functional>
+#include <type_traits>
 
 #include <ranges.hpp>
 
@@ -75,6 +76,90 @@ namespace minimize{
                 return mul(sr, r);
             };
         };
+        namespace ops{
+            template<typename T1, typename T2>
+            constexpr auto at_least = [](T1 a, T2 b) -> decltype(a + b) { return (a < b) ? b : a; };
+            template<typename T1, typename T2>
+            auto max(const T1& c1, const T2& c2){
+                using ty1 = typename T1::value_type;
+                using ty2 = typename T2::value_type;
+                using bop = decltype(at_least<ty1, ty2>);
+                return bop_range<T1, T2, bop>(at_least<ty1, ty2>, c1, c2);
+            };
+
+            template<typename T1, typename T2>
+            constexpr auto at_most = [](T1 a, T2 b) -> decltype(a + b) { return (b < a) ? b : a; };
+            template<typename T1, typename T2>
+            auto min(const T1& c1, const T2& c2){
+                using ty1 = typename T1::value_type;
+                using ty2 = typename T2::value_type;
+                using bop = decltype(at_most<ty1, ty2>);
+                return bop_range<T1, T2, bop>(at_most<ty1, ty2>, c1, c2);
+            };
+
+            // Lazy projection of r onto the box [lower, upper]
+            template<typename Range, typename Lower, typename Upper>
+            auto clamp(const Range& r, const Lower& lower, const Upper& upper){
+                return ops::max(ops::min(r, upper), lower);
+            };
+        };
+        namespace ops{
+            // Element-wise oper(a, b) for any binary callable
+            template<typename Op, typename T1, typename T2>
+            auto zip(const Op& oper, const T1& c1, const T2& c2){
+                return bop_range<T1, T2, Op>(oper, c1, c2);
+            };
+
+            // Fused x + alpha d over contiguous ranges
+            template<typename X, typename D>
+            auto axpy(const X& x, const typename X::value_type alpha, const D& d){
+                using T = typename X::value_type;
+                if(x.size() != d.size())
+                    throw std::length_error("cont1 should have same length with cont2");
+                return affine_range<T, 1>(data_of(x), x.size(), {alpha}, {data_of(d)});
+            };
+
+            // x + a1 v1 + a2 v2 + ... for a few contiguous vectors, given as
+            // coefficient, vector pairs
+            template<typename X, typename... Terms>
+            auto affine(const X& x, const Terms&... terms){
+                static_assert(sizeof...(Terms) % 2 == 0, "Terms should be coefficient, vector pairs");
+                using T = typename X::value_type;
+                constexpr std::size_t K = sizeof...(Terms) / 2;
+                std::array<T, K> coeffs;
+                std::array<const T*, K> vecs;
+                std::size_t k = 0;
+                bool same = true;
+                const auto put = [&](const auto& term){
+                    if constexpr(std::is_arithmetic<std::decay_t<decltype(term)> >::value){
+                        coeffs[k] = static_cast<T>(term);
+                    }else{
+                        same = same && (term.size() == x.size());
+                        vecs[k++] = data_of(term);
+                    };
+                };
+                (put(terms), ...);
+                if(!same) throw std::length_error("cont1 should have same length with cont2");
+                return affine_range<T, K>(data_of(x), x.size(), coeffs, vecs);
+            };
+
+            // Evaluates r into out in one pass; out may alias an operand
+            // since every element is read before it is written
+            template<typename Out, typename Range>
+            void assign(Out& out, const Range& r){
+                if(out.size() != r.size())
+                    throw std::length_error("Output should have same length with range");
+                std::copy(r.cbegin(), r.cend(), out.begin());
+            };
+
+            // Affine ranges take the vectorized single pass
+            template<typename Out, typename T, std::size_t K>
+            void assign(Out& out, const affine_range<T, K>& r){
+                if(out.size() != r.size())
+                    throw std::length_error("Output should have same length with range");
+                r.materialize(out.data());
+            };
+        };
     };
 };
 
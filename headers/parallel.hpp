@@ -0,0 +1,168 @@
+#ifndef PARALLEL
+#define PARALLEL
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <utility>
+#include <exception>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+namespace minimize{
+    namespace parallel{
+        inline std::size_t hardware_threads(void){
+            return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        };
+
+        namespace detail{
+            // Runs body on this thread, keeping what it throws in error
+            template<typename Body>
+            void guarded(std::exception_ptr& error, const Body& body){
+                try{
+                    body();
+                }catch(...){
+                    error = std::current_exception();
+                };
+            };
+
+            inline void rethrow_first(const std::vector<std::exception_ptr>& errors){
+                for(const auto& error : errors) if(error) std::rethrow_exception(error);
+            };
+        };
+
+        // Calls fn(i) for i in [0, count) split into contiguous chunks.
+        // Every thread is joined before the first exception any fn(i)
+        // threw is rethrown; a thread stops at its first one.
+        template<typename Fn>
+        void parallel_for(const std::size_t count, const std::size_t threads, const Fn& fn){
+            const std::size_t tn = std::min(std::max<std::size_t>(threads, 1), count);
+            if(tn <= 1){
+                for(std::size_t i = 0; i < count; i++) fn(i);
+                return;
+            };
+            const std::size_t chunk = (count + tn - 1) / tn;
+            std::vector<std::exception_ptr> errors(tn);
+            std::vector<std::thread> pool;
+            pool.reserve(tn - 1);
+            for(std::size_t t = 1; t < tn; t++){
+                const std::size_t beg = t * chunk, end = std::min(count, beg + chunk);
+                pool.emplace_back([&fn, &error = errors[t], beg, end](void){
+                    detail::guarded(error, [&]{ for(std::size_t i = beg; i < end; i++) fn(i); });
+                });
+            };
+            detail::guarded(errors[0], [&]{ for(std::size_t i = 0; i < std::min(count, chunk); i++) fn(i); });
+            for(auto& th : pool) th.join();
+            detail::rethrow_first(errors);
+        };
+
+        // Calls fn(i, t) for i in [0, count) handing out blocks of grain
+        // indices to whichever thread t in [0, threads) is free first.
+        // Once any fn throws no further blocks are handed out; every
+        // thread is joined, then the first exception is rethrown.
+        template<typename Fn>
+        void parallel_for_dynamic(const std::size_t count, const std::size_t threads,
+                const Fn& fn, const std::size_t grain = 16){
+            const std::size_t tn = std::min(std::max<std::size_t>(threads, 1), count);
+            const std::size_t gs = std::max<std::size_t>(grain, 1);
+            std::atomic<std::size_t> next{0};
+            std::vector<std::exception_ptr> errors(tn);
+            const auto worker = [&](const std::size_t t){
+                detail::guarded(errors[t], [&]{
+                    for(std::size_t beg = next.fetch_add(gs); beg < count; beg = next.fetch_add(gs)){
+                        const std::size_t end = std::min(count, beg + gs);
+                        for(std::size_t i = beg; i < end; i++) fn(i, t);
+                    };
+                });
+                if(errors[t]) next.store(count);
+            };
+            std::vector<std::thread> pool;
+            pool.reserve(tn);
+            for(std::size_t t = 1; t < tn; t++) pool.emplace_back(worker, t);
+            if(tn > 0) worker(0);
+            for(auto& th : pool) th.join();
+            detail::rethrow_first(errors);
+        };
+
+        // Threads kept alive across calls for short, frequent jobs: run(fn)
+        // calls fn(t) for every t in [0, size()) and returns when all are
+        // done; the calling thread acts as t = 0. run() always waits for
+        // every thread, then rethrows the first exception any fn(t) threw.
+        class team{
+            protected:
+                std::vector<std::thread> _threads;
+                std::mutex _lock;
+                std::condition_variable _start, _done;
+                const std::function<void(std::size_t)>* _job = nullptr;
+                std::size_t _generation = 0, _pending = 0;
+                bool _stop = false;
+                std::exception_ptr _error;
+                void work(const std::size_t t){
+                    std::size_t seen = 0;
+                    while(true){
+                        std::unique_lock<std::mutex> guard(_lock);
+                        _start.wait(guard, [&]{ return _stop || (_generation != seen); });
+                        if(_stop) return;
+                        seen = _generation;
+                        const auto job = _job;
+                        guard.unlock();
+                        std::exception_ptr error;
+                        try{
+                            (*job)(t);
+                        }catch(...){
+                            error = std::current_exception();
+                        };
+                        guard.lock();
+                        if(error && !_error) _error = error;
+                        if(--_pending == 0) _done.notify_one();
+                    };
+                };
+            public:
+                explicit team(const std::size_t size = hardware_threads()){
+                    for(std::size_t t = 1; t < std::max<std::size_t>(size, 1); t++)
+                        _threads.emplace_back([this, t]{ work(t); });
+                };
+                team(const team&) = delete;
+                team& operator=(const team&) = delete;
+                ~team(){
+                    {
+                        std::lock_guard<std::mutex> guard(_lock);
+                        _stop = true;
+                    };
+                    _start.notify_all();
+                    for(auto& th : _threads) th.join();
+                };
+                std::size_t size(void) const{
+                    return _threads.size() + 1;
+                };
+                template<typename Fn>
+                void run(const Fn& fn){
+                    const std::function<void(std::size_t)> job(std::cref(fn));
+                    {
+                        std::lock_guard<std::mutex> guard(_lock);
+                        _job = &job;
+                        _pending = _threads.size();
+                        _generation++;
+                    };
+                    _start.notify_all();
+                    std::exception_ptr error;
+                    try{
+                        fn(0);
+                    }catch(...){
+                        error = std::current_exception();
+                    };
+                    // job lives on this frame, so no early exit before the
+                    // workers are done with it
+                    std::unique_lock<std::mutex> guard(_lock);
+                    _done.wait(guard, [this]{ return _pending == 0; });
+                    if(!error) error = std::exchange(_error, nullptr);
+                    _error = nullptr;
+                    if(error) std::rethrow_exception(error);
+                };
+        };
+    };
+};
+
+#endif
\ No newline at end of file
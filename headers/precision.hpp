@@ -0,0 +1,57 @@
+#ifndef PRECISION
+#define PRECISION
+
+#include <limits>
+#include <vector>
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace precision{
+        using rv = double;
+
+        // Mixed precision: the solver keeps its iterate, line search and
+        // stencil sums in double, while func sees a contiguous T copy of
+        // every point and computes in T. One buffer per adapter, so use
+        // one adapter per thread. Func may be a reference type, in which
+        // case the objective is shared rather than copied.
+        template<typename T, typename Func>
+        class mixed{
+            protected:
+                Func _func;
+                mutable std::vector<T> _point;
+            public:
+                explicit mixed(Func func): _func(std::forward<Func>(func)) {};
+                template<typename Range>
+                rv operator()(const Range& r) const{
+                    _point.resize(r.size());
+                    for(std::size_t i = 0; i < _point.size(); i++) _point[i] = static_cast<T>(r.at(i));
+                    return static_cast<rv>(_func(ranges::const_range(_point)));
+                };
+        };
+
+        // Named objectives are held by reference, temporaries by value
+        template<typename T, typename Func>
+        mixed<T, Func> evaluate_in(Func&& func){
+            return mixed<T, Func>(std::forward<Func>(func));
+        };
+
+        // Gradient solver settings for objectives computed in T: the
+        // stencil step must survive rounding to T, and the gradient cannot
+        // be resolved much below sqrt(epsilon) of T
+        template<typename T>
+        grad::params params_for(grad::params p = {}){
+            p.h = derivate::default_step<T>();
+            p.tol = std::max(p.tol, static_cast<rv>(std::sqrt(std::numeric_limits<T>::epsilon())));
+            return p;
+        };
+    };
+};
+
+#endif
@@ -0,0 +1,362 @@
+#ifndef PROBLEMS
+#define PROBLEMS
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include <box_minimize.hpp>
+
+namespace minimize{
+    namespace problems{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        // Test problems are functors over ranges with a known minimizer:
+        // name(), dim(), start(), solution(), optimum() and bounds() for
+        // the box methods. Least-squares fits also write their residuals
+        // through residuals(x, out) and report residual_count().
+
+        // Extended Rosenbrock: sum 100 (x_{i+1} - x_i^2)^2 + (1 - x_i)^2
+        struct rosenbrock{
+            std::size_t n;
+            explicit rosenbrock(const std::size_t dim = 2): n(dim) {};
+            std::string name(void) const{
+                return "rosenbrock";
+            };
+            std::size_t dim(void) const{
+                return n;
+            };
+            vec start(void) const{
+                vec ret_val(n, 1.);
+                for(std::size_t i = 0; i < n; i += 2) ret_val[i] = -1.2;
+                return ret_val;
+            };
+            vec solution(void) const{
+                return vec(n, 1.);
+            };
+            rv optimum(void) const{
+                return 0.;
+            };
+            box::bounds bounds(void) const{
+                return {vec(n, -5.), vec(n, 5.)};
+            };
+            template<typename Range>
+            rv operator()(const Range& x) const{
+                rv ret_val = 0.;
+                for(std::size_t i = 0; i + 1 < x.size(); i++){
+                    const rv xi = x.at(i), a = x.at(i + 1) - xi * xi, b = 1. - xi;
+                    ret_val += 100. * a * a + b * b;
+                };
+                return ret_val;
+            };
+        };
+
+        struct beale{
+            std::string name(void) const{
+                return "beale";
+            };
+            std::size_t dim(void) const{
+                return 2;
+            };
+            vec start(void) const{
+                return {1., 1.};
+            };
+            vec solution(void) const{
+                return {3., 0.5};
+            };
+            rv optimum(void) const{
+                return 0.;
+            };
+            box::bounds bounds(void) const{
+                return {vec(2, -4.5), vec(2, 4.5)};
+            };
+            template<typename Range>
+            rv operator()(const Range& r) const{
+                const rv x = r.at(0), y = r.at(1);
+                const rv a = 1.5 - x + x * y, b = 2.25 - x + x * y * y,
+                         c = 2.625 - x + x * y * y * y;
+                return a * a + b * b + c * c;
+            };
+        };
+
+        // Extended Powell singular function, n a multiple of 4; the
+        // Hessian is singular at the minimizer
+        struct powell{
+            std::size_t n;
+            explicit powell(const std::size_t dim = 4): n(4 * std::max<std::size_t>(dim / 4, 1)) {};
+            std::string name(void) const{
+                return "powell";
+            };
+            std::size_t dim(void) const{
+                return n;
+            };
+            vec start(void) const{
+                vec ret_val(n);
+                for(std::size_t i = 0; i < n; i += 4){
+                    ret_val[i] = 3.;
+                    ret_val[i + 1] = -1.;
+                    ret_val[i + 2] = 0.;
+                    ret_val[i + 3] = 1.;
+                };
+                return ret_val;
+            };
+            vec solution(void) const{
+                return vec(n, 0.);
+            };
+            rv optimum(void) const{
+                return 0.;
+            };
+            box::bounds bounds(void) const{
+                return {vec(n, -4.), vec(n, 5.)};
+            };
+            template<typename Range>
+            rv operator()(const Range& x) const{
+                rv ret_val = 0.;
+                for(std::size_t i = 0; i + 3 < x.size(); i += 4){
+                    const rv x0 = x.at(i), x1 = x.at(i + 1), x2 = x.at(i + 2), x3 = x.at(i + 3);
+                    const rv a = x0 + 10. * x1, b = x2 - x3, c = x1 - 2. * x2, d = x0 - x3;
+                    ret_val += a * a + 5. * b * b + c * c * c * c + 10. * d * d * d * d;
+                };
+                return ret_val;
+            };
+        };
+
+        // Ackley: many regularly spaced local minima around a single
+        // global one at the origin
+        struct ackley{
+            std::size_t n;
+            explicit ackley(const std::size_t dim = 2): n(dim) {};
+            std::string name(void) const{
+                return "ackley";
+            };
+            std::size_t dim(void) const{
+                return n;
+            };
+            vec start(void) const{
+                return vec(n, 2.5);
+            };
+            vec solution(void) const{
+                return vec(n, 0.);
+            };
+            rv optimum(void) const{
+                return 0.;
+            };
+            box::bounds bounds(void) const{
+                return {vec(n, -32.768), vec(n, 32.768)};
+            };
+            template<typename Range>
+            rv operator()(const Range& x) const{
+                const rv pi = std::acos(-1.);
+                rv sq = 0., cs = 0.;
+                for(std::size_t i = 0; i < x.size(); i++){
+                    const rv xi = x.at(i);
+                    sq += xi * xi;
+                    cs += std::cos(2. * pi * xi);
+                };
+                const rv m = static_cast<rv>(x.size());
+                return - 20. * std::exp(-0.2 * std::sqrt(sq / m)) - std::exp(cs / m) + 20. + std::exp(1.);
+            };
+        };
+
+        // 0.5 x^T A x - b^T x with tridiagonal A = tridiag(-1, 2 + shift, -1)
+        // and b = 1; the shift sets the conditioning. The minimizer is
+        // found once by the Thomas algorithm.
+        struct sparse_quadratic{
+            std::size_t n;
+            rv shift;
+            vec x_star;
+            rv f_star;
+            explicit sparse_quadratic(const std::size_t dim = 1000, const rv diag_shift = 1.e-2):
+                n(dim), shift(diag_shift), x_star(dim), f_star(0.)
+                {
+                    const rv d = 2. + shift;
+                    vec c(n);
+                    rv denom = d;
+                    c[0] = -1. / denom;
+                    x_star[0] = 1. / denom;
+                    for(std::size_t i = 1; i < n; i++){
+                        denom = d + c[i - 1];
+                        c[i] = -1. / denom;
+                        x_star[i] = (1. + x_star[i - 1]) / denom;
+                    };
+                    for(std::size_t i = n - 1; i-- > 0; ) x_star[i] -= c[i] * x_star[i + 1];
+                    for(const rv xi : x_star) f_star -= 0.5 * xi;
+                };
+            std::string name(void) const{
+                return "sparse_quadratic";
+            };
+            std::size_t dim(void) const{
+                return n;
+            };
+            vec start(void) const{
+                return vec(n, 0.);
+            };
+            vec solution(void) const{
+                return x_star;
+            };
+            rv optimum(void) const{
+                return f_star;
+            };
+            box::bounds bounds(void) const{
+                const rv big = 2. * (*std::max_element(x_star.cbegin(), x_star.cend())) + 1.;
+                return {vec(n, - big), vec(n, big)};
+            };
+            template<typename Range>
+            rv operator()(const Range& x) const{
+                const rv d = 2. + shift;
+                rv ret_val = 0.;
+                for(std::size_t i = 0; i < x.size(); i++){
+                    const rv xi = x.at(i);
+                    rv ax = d * xi;
+                    if(i > 0) ax -= x.at(i - 1);
+                    if(i + 1 < x.size()) ax -= x.at(i + 1);
+                    ret_val += xi * (0.5 * ax - 1.);
+                };
+                return ret_val;
+            };
+        };
+
+        // Noise-free data fits, so the optimum is zero at the generating
+        // parameters; the objective is the sum of squared residuals
+        template<typename Model>
+        struct fit : Model{
+            std::size_t m;
+            vec t, y;
+            explicit fit(const std::size_t samples = 40):
+                m(samples), t(samples), y(samples)
+                {
+                    const vec p = Model::truth();
+                    for(std::size_t k = 0; k < m; k++){
+                        t[k] = Model::span * static_cast<rv>(k) / static_cast<rv>(m - 1);
+                        y[k] = Model::model(ranges::const_range(p), t[k]);
+                    };
+                };
+            std::size_t dim(void) const{
+                return Model::truth().size();
+            };
+            vec solution(void) const{
+                return Model::truth();
+            };
+            rv optimum(void) const{
+                return 0.;
+            };
+            std::size_t residual_count(void) const{
+                return m;
+            };
+            template<typename Range, typename Out>
+            void residuals(const Range& x, Out out) const{
+                for(std::size_t k = 0; k < m; k++, ++out) *out = Model::model(x, t[k]) - y[k];
+            };
+            template<typename Range>
+            rv operator()(const Range& x) const{
+                rv ret_val = 0.;
+                for(std::size_t k = 0; k < m; k++){
+                    const rv r = Model::model(x, t[k]) - y[k];
+                    ret_val += r * r;
+                };
+                return ret_val;
+            };
+        };
+
+        // a exp(-b t) + c
+        struct exponential_model{
+            static constexpr rv span = 4.;
+            static vec truth(void){
+                return {2.5, 1.3, 0.5};
+            };
+            std::string name(void) const{
+                return "exponential_fit";
+            };
+            vec start(void) const{
+                return {1., 0.5, 0.};
+            };
+            box::bounds bounds(void) const{
+                return {{0., 0., -5.}, {10., 5., 5.}};
+            };
+            template<typename Range>
+            static rv model(const Range& p, const rv t){
+                return p.at(0) * std::exp(- p.at(1) * t) + p.at(2);
+            };
+        };
+
+        // a exp(-(t - mu)^2 / (2 s^2))
+        struct gaussian_model{
+            static constexpr rv span = 3.;
+            static vec truth(void){
+                return {3., 1.5, 0.4};
+            };
+            std::string name(void) const{
+                return "gaussian_fit";
+            };
+            vec start(void) const{
+                return {1., 1.2, 1.};
+            };
+            box::bounds bounds(void) const{
+                return {{0., 0., 0.1}, {10., 3., 3.}};
+            };
+            template<typename Range>
+            static rv model(const Range& p, const rv t){
+                const rv z = (t - p.at(1)) / p.at(2);
+                return p.at(0) * std::exp(-0.5 * z * z);
+            };
+        };
+
+        using exponential_fit = fit<exponential_model>;
+        using gaussian_fit = fit<gaussian_model>;
+
+        // Forwards calls to a problem and counts them; safe to share
+        // between the threads of the parallel methods
+        template<typename Problem>
+        class counted{
+            protected:
+                const Problem& _problem;
+                mutable std::atomic<std::size_t> _calls;
+            public:
+                explicit counted(const Problem& problem): _problem(problem), _calls(0) {};
+                std::size_t calls(void) const{
+                    return _calls.load();
+                };
+                template<typename Range>
+                rv operator()(const Range& x) const{
+                    _calls.fetch_add(1, std::memory_order_relaxed);
+                    return _problem(x);
+                };
+                template<typename Range, typename Out>
+                void operator()(const Range& x, Out out) const{
+                    _calls.fetch_add(1, std::memory_order_relaxed);
+                    _problem.residuals(x, out);
+                };
+        };
+
+        // Distance of x to the known minimizer
+        template<typename Problem>
+        rv solution_error(const Problem& p, const vec& x){
+            const vec s = p.solution();
+            rv ret_val = 0.;
+            for(std::size_t i = 0; i < s.size(); i++) ret_val += (x[i] - s[i]) * (x[i] - s[i]);
+            return std::sqrt(ret_val);
+        };
+
+        // The standard suite; large sets the size of the sparse quadratic
+        template<typename Visitor>
+        void suite(Visitor&& visit, const std::size_t large = 1000){
+            visit(rosenbrock(2));
+            visit(rosenbrock(10));
+            visit(beale());
+            visit(powell(4));
+            visit(powell(12));
+            visit(ackley(2));
+            visit(ackley(10));
+            visit(sparse_quadratic(large));
+            visit(exponential_fit());
+            visit(gaussian_fit());
+        };
+    };
+};
+
+#endif
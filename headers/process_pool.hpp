@@ -0,0 +1,200 @@
+#ifndef PROCESS_POOL
+#define PROCESS_POOL
+
+#include <new>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <semaphore.h>
+
+#include <ranges.hpp>
+#include <evaluate.hpp>
+
+namespace minimize{
+    namespace evaluate{
+        namespace detail{
+            enum slot_state : int{
+                empty = 0,
+                filled = 1,
+                done = 2,
+                failed = 3
+            };
+
+            struct ring_header{
+                sem_t items, done;
+                std::atomic<std::size_t> head;
+                std::atomic<bool> stop;
+            };
+
+            // A slot header is followed by dim coordinates in the same line
+            struct alignas(64) slot_header{
+                std::atomic<int> state;
+                std::size_t dim;
+                rv value;
+            };
+
+            inline void wait_sem(sem_t* s){
+                while(sem_wait(s) != 0)
+                    if(errno != EINTR) throw std::runtime_error("sem_wait failed");
+            };
+
+            // As wait_sem but gives up after ms milliseconds, returning false
+            inline bool wait_sem_for(sem_t* s, const long ms){
+                timespec until;
+                clock_gettime(CLOCK_REALTIME, &until);
+                until.tv_nsec += ms * 1000000L;
+                until.tv_sec += until.tv_nsec / 1000000000L;
+                until.tv_nsec %= 1000000000L;
+                while(sem_timedwait(s, &until) != 0){
+                    if(errno == ETIMEDOUT) return false;
+                    if(errno != EINTR) throw std::runtime_error("sem_timedwait failed");
+                };
+                return true;
+            };
+        };
+
+        // Batched evaluator for objectives that are not reentrant: func runs
+        // in forked worker processes, each with its own copy of the global
+        // state. Points and values go through a ring of slots in anonymous
+        // shared memory; at most capacity points are in flight. Construct
+        // it before the process starts other threads. A worker that dies,
+        // e.g. crashing inside func, fails the batch in flight and every
+        // later one with runtime_error.
+        template<typename Func>
+        class process_evaluator{
+            protected:
+                const std::size_t _dim, _capacity, _stride;
+                std::size_t _bytes;
+                void* _memory;
+                std::vector<pid_t> _workers;
+                mutable bool _broken = false;
+                detail::ring_header* header(void) const{
+                    return static_cast<detail::ring_header*>(_memory);
+                };
+                static constexpr std::size_t header_bytes = (sizeof(detail::ring_header) + 63) / 64 * 64;
+                detail::slot_header* slot(const std::size_t k) const{
+                    return reinterpret_cast<detail::slot_header*>(
+                        static_cast<char*>(_memory) + header_bytes + (k % _capacity) * _stride);
+                };
+                static rv* coords(detail::slot_header* s){
+                    return reinterpret_cast<rv*>(s + 1);
+                };
+                [[noreturn]] void work(const Func& func) const{
+                    detail::ring_header* h = header();
+                    vec x(_dim);
+                    while(true){
+                        detail::wait_sem(&h->items);
+                        if(h->stop.load()) _exit(0);
+                        detail::slot_header* s = slot(h->head.fetch_add(1));
+                        const rv* c = coords(s);
+                        std::copy(c, c + s->dim, x.begin());
+                        int state = detail::done;
+                        try{
+                            s->value = func(ranges::const_range<vec>(x.cbegin(), x.cbegin() + s->dim));
+                        }catch(...){
+                            state = detail::failed;
+                        };
+                        s->state.store(state, std::memory_order_release);
+                        sem_post(&h->done);
+                    };
+                };
+                // Polled while waiting, as a dead worker never posts done
+                void check_workers(void) const{
+                    for(const pid_t pid : _workers){
+                        if(waitpid(pid, nullptr, WNOHANG) == pid){
+                            _broken = true;
+                            throw std::runtime_error("Worker process died");
+                        };
+                    };
+                };
+                void shutdown(void){
+                    header()->stop.store(true);
+                    for(std::size_t w = 0; w < _workers.size(); w++) sem_post(&header()->items);
+                    for(const pid_t pid : _workers) waitpid(pid, nullptr, 0);
+                    sem_destroy(&header()->items);
+                    sem_destroy(&header()->done);
+                    munmap(_memory, _bytes);
+                };
+            public:
+                process_evaluator(const Func& func, const std::size_t dim,
+                        const std::size_t workers = parallel::hardware_threads(),
+                        const std::size_t capacity = 0):
+                    _dim(dim),
+                    _capacity(capacity ? capacity : 4 * std::max<std::size_t>(workers, 1)),
+                    _stride((sizeof(detail::slot_header) + dim * sizeof(rv) + 63) / 64 * 64),
+                    _bytes(header_bytes + _capacity * _stride),
+                    _memory(mmap(nullptr, _bytes, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0))
+                    {
+                        if(_memory == MAP_FAILED) throw std::runtime_error("Shared ring allocation failed");
+                        detail::ring_header* h = new(_memory) detail::ring_header;
+                        h->head.store(0);
+                        h->stop.store(false);
+                        sem_init(&h->items, 1, 0);
+                        sem_init(&h->done, 1, 0);
+                        for(std::size_t k = 0; k < _capacity; k++)
+                            new(slot(k)) detail::slot_header{{detail::empty}, 0, 0.};
+                        for(std::size_t w = 0; w < std::max<std::size_t>(workers, 1); w++){
+                            const pid_t pid = fork();
+                            if(pid == 0) work(func);
+                            if(pid < 0){
+                                shutdown();
+                                throw std::runtime_error("Worker fork failed");
+                            };
+                            _workers.push_back(pid);
+                        };
+                    };
+                process_evaluator(const process_evaluator&) = delete;
+                process_evaluator& operator=(const process_evaluator&) = delete;
+                ~process_evaluator(){
+                    shutdown();
+                };
+                std::size_t workers(void) const{
+                    return _workers.size();
+                };
+                // Slots are reused in order: a slot is refilled only after
+                // its value has been collected. One caller at a time.
+                void operator()(const vec& points, const std::size_t n, vec& values) const{
+                    if((n > _dim) || (points.size() != values.size() * n))
+                        throw std::length_error("Points should hold one row per value, at most dim wide");
+                    if(_broken) throw std::runtime_error("Worker process died");
+                    detail::ring_header* h = header();
+                    const std::size_t m = values.size(), base = h->head.load();
+                    std::size_t submitted = 0, collected = 0, received = 0;
+                    bool failed = false;
+                    while(received < m){
+                        for(; (submitted < m) && (submitted - collected < _capacity); submitted++){
+                            detail::slot_header* s = slot(base + submitted);
+                            s->dim = n;
+                            std::copy(points.cbegin() + submitted * n,
+                                points.cbegin() + (submitted + 1) * n, coords(s));
+                            s->state.store(detail::filled, std::memory_order_release);
+                            sem_post(&h->items);
+                        };
+                        while(!detail::wait_sem_for(&h->done, 50)) check_workers();
+                        received++;
+                        for(; collected < submitted; collected++){
+                            detail::slot_header* s = slot(base + collected);
+                            const int state = s->state.load(std::memory_order_acquire);
+                            if(state == detail::filled) break;
+                            failed = failed || (state == detail::failed);
+                            values[collected] = s->value;
+                            s->state.store(detail::empty, std::memory_order_relaxed);
+                        };
+                    };
+                    if(failed) throw std::runtime_error("Objective failed in a worker process");
+                };
+        };
+    };
+};
+
+#endif
@@ -1,7 +1,11 @@
 #ifndef RANGES
 #define RANGES
 
+#include <array>
+#include <cmath>
+#include <vector>
 #include <utility>
+#include <stdexcept>
 #include <iterator>
 #include <algorithm>
 #include <functional>
@@ -12,11 +16,11 @@ namespace minimize{
         namespace iters{
             template<typename it>
             class iterator : 
-                    public std::iterator<std::forward_iterator_tag, typename it::value_type>{
+                    public std::iterator<std::forward_iterator_tag, typename std::iterator_traits<it>::value_type>{
                 public:
-                    using value_type = typename it::value_type;
-                    using reference = typename it::reference;
-                    using const_reference = typename it::reference;
+                    using value_type = typename std::iterator_traits<it>::value_type;
+                    using reference = typename std::iterator_traits<it>::reference;
+                    using const_reference = typename std::iterator_traits<it>::reference;
                 protected:
                     it _current;
                 public:
@@ -57,9 +61,9 @@ namespace minimize{
             template<typename it>
             class num_iterator : public iterator<it>{
                 public:
-                    using value_type = typename it::value_type;
-                    using reference = typename it::reference;
-                    using const_reference = const typename it::reference;
+                    using value_type = typename std::iterator_traits<it>::value_type;
+                    using reference = typename std::iterator_traits<it>::reference;
+                    using const_reference = const typename std::iterator_traits<it>::reference;
                 protected:
                     const it _begin;
                 public:
@@ -92,9 +96,9 @@ namespace minimize{
             template<typename it>
             class subs_iterator : public num_iterator<it>{
                 public:
-                    using value_type = typename it::value_type;
-                    using reference = typename it::reference;
-                    using const_reference = const typename it::reference;
+                    using value_type = typename std::iterator_traits<it>::value_type;
+                    using reference = typename std::iterator_traits<it>::reference;
+                    using const_reference = const typename std::iterator_traits<it>::reference;
                     using subs = typename std::pair<const std::size_t, value_type>;
                 protected:
                     subs _body;
@@ -140,10 +144,10 @@ namespace minimize{
                     value_type operator*(void) const{
                         return _oper(*_cur1, *_cur2);
                     };
-                    value_type operator++(void){
+                    bop_iterator<it1, it2, op>& operator++(void){
                         _cur1++;
                         _cur2++;
-                        return operator*();
+                        return *this;
                     };
                     value_type operator++(int){
                         value_type ret_val = operator*();
@@ -157,7 +161,7 @@ namespace minimize{
                         return !operator==(oth);
                     };
                     it1 current(void) const{
-                        return *_cur1;
+                        return _cur1;
                     };
             };
             template<typename T>
@@ -201,7 +205,7 @@ namespace minimize{
                         return (_num == si._num);
                     };
                     bool operator!=(const scalar_iterator<T>& si) const{
-                        return operator==(si);
+                        return !operator==(si);
                     };
                     std::size_t current(void) const{
                         return _num;
@@ -210,7 +214,7 @@ namespace minimize{
         };
         namespace dists{
             template<typename it>
-            typename it::difference_type distance(it first, it last){
+            typename std::iterator_traits<it>::difference_type distance(it first, it last){
                 //std::cout << "Std distance" << std::endl;
                 return std::distance(first, last);
             };
@@ -232,18 +236,18 @@ namespace minimize{
                 //std::cout << "Subs iterator distance" << std::endl;
                 return distance<it>(first.current(), last.current());
             };
-            template<typename it1, typename it2, typename op>
-            typename iters::bop_iterator<it1, it2, op>::difference_type distance(
-                    iters::bop_iterator<it1, it2, op> first, iters::bop_iterator<it1, it2, op> last){
-                //std::cout << "Bop iterator distance" << std::endl;
-                return distance(first.current(), last.current());
-            };
             template<typename T>
             typename iters::scalar_iterator<T>::difference_type distance(
                     iters::scalar_iterator<T> first,  iters::scalar_iterator<T> last){
                 //std::cout << "Scalar iterator distance" << std::endl;
                 return last.current() - first.current();
             };
+            template<typename it1, typename it2, typename op>
+            typename iters::bop_iterator<it1, it2, op>::difference_type distance(
+                    iters::bop_iterator<it1, it2, op> first, iters::bop_iterator<it1, it2, op> last){
+                //std::cout << "Bop iterator distance" << std::endl;
+                return dists::distance(first.current(), last.current());
+            };
         };
         template<typename T, typename it>
         class range_proto{
@@ -490,7 +494,7 @@ namespace minimize{
                 iterator cend(void) const{
                     return iterator(_oper, _end1, _end2);
                 };
-                iterator begin(void) const{ return begin();};
+                iterator begin(void) const{ return cbegin();};
                 iterator end(void) const{ return cend(); };
             protected:
                 it1 iterator1_at(const std::size_t i) const{
@@ -510,6 +514,315 @@ namespace minimize{
                     return _size;
                 };
         };
+        namespace detail{
+            // a * v + r, fused where the target has a fast fma
+            template<typename T>
+            inline T madd(const T a, const T v, const T r){
+#ifdef FP_FAST_FMA
+                return std::fma(a, v, r);
+#else
+                return a * v + r;
+#endif
+            };
+
+            template<typename T, std::size_t K>
+            class affine_iterator{
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = const T*;
+                    using reference = T;
+                    using const_reference = T;
+                protected:
+                    const T* _base;
+                    std::array<const T*, K> _vecs;
+                    std::array<T, K> _coeffs;
+                    std::size_t _num;
+                public:
+                    affine_iterator(const T* base, const std::array<const T*, K>& vecs,
+                            const std::array<T, K>& coeffs, const std::size_t num):
+                        _base(base), _vecs(vecs), _coeffs(coeffs), _num(num)
+                        {};
+                    T operator*(void) const{
+                        T ret_val = _base[_num];
+                        for(std::size_t k = 0; k < K; k++)
+                            ret_val = madd(_coeffs[k], _vecs[k][_num], ret_val);
+                        return ret_val;
+                    };
+                    affine_iterator<T, K>& operator++(void){
+                        _num++;
+                        return *this;
+                    };
+                    affine_iterator<T, K> operator++(int){
+                        affine_iterator<T, K> ret_val(*this);
+                        _num++;
+                        return ret_val;
+                    };
+                    bool operator==(const affine_iterator<T, K>& oth) const{
+                        return _num == oth._num;
+                    };
+                    bool operator!=(const affine_iterator<T, K>& oth) const{
+                        return !operator==(oth);
+                    };
+                    std::size_t current(void) const{
+                        return _num;
+                    };
+            };
+        };
+        namespace dists{
+            template<typename T, std::size_t K>
+            std::ptrdiff_t distance(detail::affine_iterator<T, K> first, detail::affine_iterator<T, K> last){
+                return static_cast<std::ptrdiff_t>(last.current() - first.current());
+            };
+        };
+        // Lazy x + sum_k alpha_k v_k over K contiguous vectors of T. Holds
+        // raw pointers and scalars only; an element costs K fused
+        // multiply-adds and materialize() is one pass over all operands.
+        // The operands must outlive the range.
+        template<typename T, std::size_t K>
+        class affine_range{
+            public:
+                using value_type = T;
+                using reference = T;
+                using const_reference = T;
+                using iterator = detail::affine_iterator<T, K>;
+                using const_iterator = iterator;
+            protected:
+                const T* _base;
+                std::array<const T*, K> _vecs;
+                std::array<T, K> _coeffs;
+                std::size_t _size;
+            public:
+                affine_range(const T* base, const std::size_t size,
+                        const std::array<T, K>& coeffs, const std::array<const T*, K>& vecs):
+                    _base(base), _vecs(vecs), _coeffs(coeffs), _size(size)
+                    {};
+                affine_range(const affine_range<T, K>&) = default;
+                std::size_t size(void) const{
+                    return _size;
+                };
+                T coefficient(const std::size_t k) const{
+                    return _coeffs[k];
+                };
+                T at(const std::size_t i) const{
+                    T ret_val = _base[i];
+                    for(std::size_t k = 0; k < K; k++)
+                        ret_val = detail::madd(_coeffs[k], _vecs[k][i], ret_val);
+                    return ret_val;
+                };
+                const_iterator cbegin(void) const{
+                    return const_iterator(_base, _vecs, _coeffs, 0);
+                };
+                const_iterator cend(void) const{
+                    return const_iterator(_base, _vecs, _coeffs, _size);
+                };
+                iterator begin(void) const{ return cbegin(); };
+                iterator end(void) const{ return cend(); };
+                // Writes all elements to out, which may alias an operand;
+                // K is a compile-time constant, so the inner loop unrolls
+                // and the outer one vectorizes
+                void materialize(T* out) const{
+                    for(std::size_t i = 0; i < _size; i++){
+                        T v = _base[i];
+                        for(std::size_t k = 0; k < K; k++) v = detail::madd(_coeffs[k], _vecs[k][i], v);
+                        out[i] = v;
+                    };
+                };
+        };
+        // Evaluated copy of a lazy range. Objectives reading elements more
+        // than once get plain loads instead of recomputing the expression;
+        // up to N elements live inline, larger ranges go to the heap.
+        template<typename T, std::size_t N = 16>
+        class cached_range{
+            public:
+                using value_type = T;
+                using reference = const T&;
+                using const_reference = const T&;
+                using iterator = const T*;
+                using const_iterator = const T*;
+                static constexpr std::size_t inline_capacity = N;
+            protected:
+                std::size_t _size;
+                std::array<T, N> _inline;
+                std::vector<T> _heap;
+            public:
+                template<typename Range>
+                explicit cached_range(const Range& r): _size(r.size()){
+                    if(_size > N) _heap.resize(_size);
+                    std::copy(r.cbegin(), r.cend(), storage());
+                };
+                cached_range(const cached_range<T, N>&) = default;
+                std::size_t size(void) const{
+                    return _size;
+                };
+                const T* data(void) const{
+                    return (_size > N) ? _heap.data() : _inline.data();
+                };
+                const_reference at(const std::size_t i) const{
+                    return data()[i];
+                };
+                const_iterator cbegin(void) const{
+                    return data();
+                };
+                const_iterator cend(void) const{
+                    return data() + _size;
+                };
+                iterator begin(void) const{ return cbegin(); };
+                iterator end(void) const{ return cend(); };
+            protected:
+                T* storage(void){
+                    return (_size > N) ? _heap.data() : _inline.data();
+                };
+        };
+        template<typename Range>
+        cached_range<typename Range::value_type> cached(const Range& r){
+            return cached_range<typename Range::value_type>(r);
+        };
+        // Non-owning view of size elements at data. Shaped like a
+        // container, so const_range, subs_range and the ops accept it and
+        // memory owned elsewhere is used in place.
+        template<typename T>
+        class span{
+            public:
+                using value_type = T;
+                using reference = const T&;
+                using const_reference = const T&;
+                using iterator = const T*;
+                using const_iterator = const T*;
+            protected:
+                const T* _data;
+                std::size_t _size;
+            public:
+                span(const T* data, const std::size_t size): _data(data), _size(size) {};
+                std::size_t size(void) const{
+                    return _size;
+                };
+                const T* data(void) const{
+                    return _data;
+                };
+                const_iterator cbegin(void) const{
+                    return _data;
+                };
+                const_iterator cend(void) const{
+                    return _data + _size;
+                };
+                iterator begin(void) const{ return cbegin(); };
+                iterator end(void) const{ return cend(); };
+        };
+        template<typename T>
+        const_range<span<T> > span_range(const T* data, const std::size_t size){
+            return const_range<span<T> >(span<T>(data, size));
+        };
+        namespace iters{
+            template<typename T>
+            class strided_iterator{
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = const T*;
+                    using reference = const T&;
+                    using const_reference = const T&;
+                protected:
+                    const T* _data;
+                    std::ptrdiff_t _stride;
+                    std::size_t _num;
+                public:
+                    strided_iterator(const T* data, const std::ptrdiff_t stride, const std::size_t num):
+                        _data(data), _stride(stride), _num(num)
+                        {};
+                    const_reference operator*(void) const{
+                        return _data[static_cast<std::ptrdiff_t>(_num) * _stride];
+                    };
+                    strided_iterator<T>& operator++(void){
+                        _num++;
+                        return *this;
+                    };
+                    strided_iterator<T> operator++(int){
+                        strided_iterator<T> ret_val(*this);
+                        operator++();
+                        return ret_val;
+                    };
+                    bool operator==(const strided_iterator<T>& oth) const{
+                        return _num == oth._num;
+                    };
+                    bool operator!=(const strided_iterator<T>& oth) const{
+                        return !operator==(oth);
+                    };
+                    std::size_t current(void) const{
+                        return _num;
+                    };
+            };
+        };
+        namespace dists{
+            template<typename T>
+            std::ptrdiff_t distance(iters::strided_iterator<T> first, iters::strided_iterator<T> last){
+                return static_cast<std::ptrdiff_t>(last.current() - first.current());
+            };
+        };
+        // Every stride-th element from data, e.g. one field of an array of
+        // structures: strided_range(&pts[0].y, pts.size(), sizeof(point) / sizeof(double))
+        template<typename T>
+        class strided_range{
+            public:
+                using value_type = T;
+                using reference = const T&;
+                using const_reference = const T&;
+                using iterator = iters::strided_iterator<T>;
+                using const_iterator = iterator;
+            protected:
+                const T* _data;
+                std::size_t _size;
+                std::ptrdiff_t _stride;
+            public:
+                strided_range(const T* data, const std::size_t size, const std::ptrdiff_t stride):
+                    _data(data), _size(size), _stride(stride)
+                    {
+                        if(stride <= 0) throw std::invalid_argument("Stride should be positive");
+                    };
+                std::size_t size(void) const{
+                    return _size;
+                };
+                std::ptrdiff_t stride(void) const{
+                    return _stride;
+                };
+                const_reference at(const std::size_t i) const{
+                    return _data[static_cast<std::ptrdiff_t>(i) * _stride];
+                };
+                const_iterator cbegin(void) const{
+                    return const_iterator(_data, _stride, 0);
+                };
+                const_iterator cend(void) const{
+                    return const_iterator(_data, _stride, _size);
+                };
+                iterator begin(void) const{ return cbegin(); };
+                iterator end(void) const{ return cend(); };
+        };
+        // Ranges whose elements sit in one array, viewable by pointer
+        template<typename R>
+        struct contiguous : std::false_type{};
+
+        template<typename T, typename A>
+        struct contiguous<std::vector<T, A> > : std::true_type{};
+
+        template<typename T, std::size_t N>
+        struct contiguous<std::array<T, N> > : std::true_type{};
+
+        template<typename C>
+        struct contiguous<const_range<C> > : contiguous<C>{};
+
+        template<typename T, std::size_t N>
+        struct contiguous<cached_range<T, N> > : std::true_type{};
+
+        template<typename T>
+        struct contiguous<span<T> > : std::true_type{};
+
+        template<typename R>
+        const typename R::value_type* data_of(const R& r){
+            static_assert(contiguous<R>::value, "Range should be contiguous");
+            return (r.size() == 0) ? nullptr : &*r.cbegin();
+        };
     };
 }; 
 
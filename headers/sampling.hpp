@@ -0,0 +1,121 @@
+#ifndef SAMPLING
+#define SAMPLING
+
+#include <array>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+namespace minimize{
+    namespace sampling{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        namespace constants{
+            struct sobol_poly{
+                const unsigned s, a;
+                const std::array<std::uint32_t, 6> m;
+            };
+            // Joe & Kuo direction numbers for dimensions 2, ..., 16
+            constexpr std::array<sobol_poly, 15> sobol_polys{{
+                {1, 0, {1}},
+                {2, 1, {1, 3}},
+                {3, 1, {1, 3, 1}},
+                {3, 2, {1, 1, 1}},
+                {4, 1, {1, 1, 3, 3}},
+                {4, 4, {1, 3, 5, 13}},
+                {5, 2, {1, 1, 5, 5, 17}},
+                {5, 4, {1, 1, 5, 5, 5}},
+                {5, 7, {1, 1, 7, 11, 19}},
+                {5, 11, {1, 1, 5, 1, 1}},
+                {5, 13, {1, 1, 1, 3, 11}},
+                {5, 14, {1, 3, 5, 5, 31}},
+                {6, 1, {1, 3, 3, 9, 7, 49}},
+                {6, 13, {1, 1, 1, 15, 21, 21}},
+                {6, 16, {1, 3, 1, 13, 27, 49}}
+            }};
+        };
+
+        // Gray-code Sobol sequence; the all-zero first point is skipped
+        class sobol{
+            public:
+                static constexpr std::size_t max_dim = constants::sobol_polys.size() + 1;
+            protected:
+                static constexpr std::size_t bits = 32;
+                const std::size_t _dim;
+                std::vector<std::uint32_t> _dirs, _state;
+                std::uint32_t _index = 0;
+            public:
+                explicit sobol(const std::size_t dim):
+                    _dim(dim), _dirs(dim * bits), _state(dim, 0)
+                    {
+                        if((dim == 0) || (dim > max_dim))
+                            throw std::length_error("Sobol dimension should be in [1, sobol::max_dim]");
+                        for(std::size_t k = 0; k < bits; k++)
+                            _dirs[k] = std::uint32_t(1) << (bits - 1 - k);
+                        for(std::size_t j = 1; j < dim; j++){
+                            const auto& p = constants::sobol_polys[j - 1];
+                            std::uint32_t* v = _dirs.data() + j * bits;
+                            for(std::size_t k = 0; k < p.s; k++)
+                                v[k] = p.m[k] << (bits - 1 - k);
+                            for(std::size_t k = p.s; k < bits; k++){
+                                v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+                                for(std::size_t i = 1; i < p.s; i++)
+                                    if((p.a >> (p.s - 1 - i)) & 1u) v[k] ^= v[k - i];
+                            };
+                        };
+                    };
+                std::size_t dim(void) const{
+                    return _dim;
+                };
+                // Writes the next point of [0, 1)^dim into out
+                template<typename Out>
+                void next(Out out){
+                    std::size_t c = 0;
+                    for(std::uint32_t i = _index; i & 1u; i >>= 1) c++;
+                    _index++;
+                    for(std::size_t j = 0; j < _dim; j++){
+                        _state[j] ^= _dirs[j * bits + c];
+                        out[j] = static_cast<rv>(_state[j]) / 4294967296.;
+                    };
+                };
+        };
+
+        // Latin hypercube: each axis split into count strata, one point per stratum
+        template<typename Gen>
+        vec latin_hypercube(const std::size_t count, const std::size_t dim, Gen& gen){
+            vec ret_val(count * dim);
+            std::vector<std::size_t> perm(count);
+            std::uniform_real_distribution<rv> u(0., 1.);
+            for(std::size_t j = 0; j < dim; j++){
+                std::iota(perm.begin(), perm.end(), 0);
+                std::shuffle(perm.begin(), perm.end(), gen);
+                for(std::size_t i = 0; i < count; i++)
+                    ret_val[i * dim + j] = (static_cast<rv>(perm[i]) + u(gen)) / static_cast<rv>(count);
+            };
+            return ret_val;
+        };
+
+        inline vec sobol_points(const std::size_t count, const std::size_t dim){
+            vec ret_val(count * dim);
+            sobol gen(dim);
+            for(std::size_t i = 0; i < count; i++) gen.next(ret_val.begin() + i * dim);
+            return ret_val;
+        };
+
+        // Maps unit-cube points in place onto the box [lower, upper]
+        inline void scale(vec& points, const vec& lower, const vec& upper){
+            const std::size_t dim = lower.size();
+            for(std::size_t i = 0; i < points.size(); i++){
+                const std::size_t j = i % dim;
+                points[i] = lower[j] + points[i] * (upper[j] - lower[j]);
+            };
+        };
+    };
+};
+
+#endif
\ No newline at end of file
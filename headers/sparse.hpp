@@ -0,0 +1,336 @@
+#ifndef SPARSE
+#define SPARSE
+
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <operations.hpp>
+
+namespace minimize{
+    namespace ranges{
+        namespace iters{
+            // Walks every position of a sparse range, yielding zeros between
+            // the stored entries, so dense code can read sparse operands
+            template<typename T>
+            class sparse_iterator{
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = const T*;
+                    using reference = T;
+                    using const_reference = T;
+                protected:
+                    const std::size_t* _index;
+                    const T* _values;
+                    std::size_t _nnz, _num, _k;
+                    T _scale;
+                public:
+                    sparse_iterator(const std::size_t* index, const T* values, const std::size_t nnz,
+                            const T scale, const std::size_t num, const std::size_t k):
+                        _index(index), _values(values), _nnz(nnz), _num(num), _k(k), _scale(scale)
+                        {};
+                    T operator*(void) const{
+                        return ((_k < _nnz) && (_index[_k] == _num)) ? _scale * _values[_k] : T(0);
+                    };
+                    sparse_iterator<T>& operator++(void){
+                        if((_k < _nnz) && (_index[_k] == _num)) _k++;
+                        _num++;
+                        return *this;
+                    };
+                    sparse_iterator<T> operator++(int){
+                        sparse_iterator<T> ret_val(*this);
+                        operator++();
+                        return ret_val;
+                    };
+                    bool operator==(const sparse_iterator<T>& oth) const{
+                        return _num == oth._num;
+                    };
+                    bool operator!=(const sparse_iterator<T>& oth) const{
+                        return !operator==(oth);
+                    };
+                    std::size_t current(void) const{
+                        return _num;
+                    };
+            };
+        };
+        namespace dists{
+            template<typename T>
+            std::ptrdiff_t distance(iters::sparse_iterator<T> first, iters::sparse_iterator<T> last){
+                return static_cast<std::ptrdiff_t>(last.current() - first.current());
+            };
+        };
+
+        // View of a vector of size elements of which only nnz are stored:
+        // strictly increasing positions index[k] holding scale * values[k].
+        // Element access is a binary search and the iterators are dense;
+        // the sparse ops below work on the stored entries only.
+        template<typename T>
+        class sparse_range{
+            public:
+                using value_type = T;
+                using reference = T;
+                using const_reference = T;
+                using iterator = iters::sparse_iterator<T>;
+                using const_iterator = iterator;
+            protected:
+                const std::size_t* _index;
+                const T* _values;
+                std::size_t _nnz, _size;
+                T _scale;
+            public:
+                sparse_range(const std::size_t size, const std::size_t* index, const T* values,
+                        const std::size_t nnz, const T scale = T(1)):
+                    _index(index), _values(values), _nnz(nnz), _size(size), _scale(scale)
+                    {};
+                std::size_t size(void) const{
+                    return _size;
+                };
+                std::size_t nnz(void) const{
+                    return _nnz;
+                };
+                std::size_t index(const std::size_t k) const{
+                    return _index[k];
+                };
+                T value(const std::size_t k) const{
+                    return _scale * _values[k];
+                };
+                T at(const std::size_t i) const{
+                    const std::size_t* pos = std::lower_bound(_index, _index + _nnz, i);
+                    return ((pos != _index + _nnz) && (*pos == i)) ? _scale * _values[pos - _index] : T(0);
+                };
+                // Same pattern with every value multiplied by a
+                sparse_range<T> scaled(const T a) const{
+                    return sparse_range<T>(_size, _index, _values, _nnz, a * _scale);
+                };
+                const_iterator cbegin(void) const{
+                    return const_iterator(_index, _values, _nnz, _scale, 0, 0);
+                };
+                const_iterator cend(void) const{
+                    return const_iterator(_index, _values, _nnz, _scale, _size, _nnz);
+                };
+                iterator begin(void) const{ return cbegin(); };
+                iterator end(void) const{ return cend(); };
+        };
+
+        // Owning storage for a sparse_range; entries are appended in
+        // increasing position order
+        template<typename T>
+        class sparse_vector{
+            protected:
+                std::size_t _size;
+                std::vector<std::size_t> _index;
+                std::vector<T> _values;
+            public:
+                using value_type = T;
+                explicit sparse_vector(const std::size_t size = 0): _size(size) {};
+                sparse_vector(const std::size_t size, std::vector<std::size_t> index, std::vector<T> values):
+                    _size(size), _index(std::move(index)), _values(std::move(values))
+                    {
+                        if(_index.size() != _values.size())
+                            throw std::length_error("Index should have same length with values");
+                        for(std::size_t k = 0; k < _index.size(); k++){
+                            if(((k > 0) && (_index[k] <= _index[k - 1])) || (_index[k] >= _size))
+                                throw std::logic_error("Index should be increasing and less than size");
+                        };
+                    };
+                void push_back(const std::size_t i, const T v){
+                    if((i >= _size) || (!_index.empty() && (i <= _index.back())))
+                        throw std::logic_error("Index should be increasing and less than size");
+                    _index.push_back(i);
+                    _values.push_back(v);
+                };
+                void reserve(const std::size_t nnz){
+                    _index.reserve(nnz);
+                    _values.reserve(nnz);
+                };
+                void clear(void){
+                    _index.clear();
+                    _values.clear();
+                };
+                std::size_t size(void) const{
+                    return _size;
+                };
+                std::size_t nnz(void) const{
+                    return _index.size();
+                };
+                const std::vector<std::size_t>& index(void) const{
+                    return _index;
+                };
+                const std::vector<T>& values(void) const{
+                    return _values;
+                };
+                std::vector<T>& values(void){
+                    return _values;
+                };
+                // Valid until the next push_back
+                sparse_range<T> range(void) const{
+                    return sparse_range<T>(_size, _index.data(), _values.data(), _index.size());
+                };
+        };
+
+        // Nonzero elements of a dense range
+        template<typename Range>
+        sparse_vector<typename Range::value_type> sparse(const Range& r){
+            using T = typename Range::value_type;
+            sparse_vector<T> ret_val(r.size());
+            std::size_t i = 0;
+            for(auto it = r.cbegin(); it != r.cend(); ++it, i++){
+                const T v = *it;
+                if(v != T(0)) ret_val.push_back(i, v);
+            };
+            return ret_val;
+        };
+
+        namespace ops{
+            namespace detail{
+                inline void check_sizes(const std::size_t a, const std::size_t b){
+                    if(a != b) throw std::length_error("cont1 should have same length with cont2");
+                };
+
+                // Union of two patterns, combining matching entries by op
+                template<typename T, typename Op>
+                sparse_vector<T> merge(const sparse_range<T>& a, const sparse_range<T>& b, const Op& op){
+                    check_sizes(a.size(), b.size());
+                    sparse_vector<T> ret_val(a.size());
+                    ret_val.reserve(a.nnz() + b.nnz());
+                    std::size_t i = 0, j = 0;
+                    while((i < a.nnz()) || (j < b.nnz())){
+                        if((j == b.nnz()) || ((i < a.nnz()) && (a.index(i) < b.index(j)))){
+                            ret_val.push_back(a.index(i), op(a.value(i), T(0)));
+                            i++;
+                        }else if((i == a.nnz()) || (b.index(j) < a.index(i))){
+                            ret_val.push_back(b.index(j), op(T(0), b.value(j)));
+                            j++;
+                        }else{
+                            ret_val.push_back(a.index(i), op(a.value(i), b.value(j)));
+                            i++;
+                            j++;
+                        };
+                    };
+                    return ret_val;
+                };
+            };
+
+            // O(1): only the scale of the view changes
+            template<typename U, typename T>
+            sparse_range<T> scalar_mul(const U& v, const sparse_range<T>& r){
+                return r.scaled(static_cast<T>(v));
+            };
+
+            template<typename T>
+            sparse_vector<T> sum(const sparse_range<T>& a, const sparse_range<T>& b){
+                return detail::merge(a, b, plus<T, T>);
+            };
+
+            template<typename T>
+            sparse_vector<T> sub(const sparse_range<T>& a, const sparse_range<T>& b){
+                return detail::merge(a, b, minus<T, T>);
+            };
+
+            // Element-wise products keep the pattern of the sparse operand
+            template<typename T, typename Range>
+            sparse_vector<T> mul(const sparse_range<T>& a, const Range& b){
+                detail::check_sizes(a.size(), b.size());
+                sparse_vector<T> ret_val(a.size());
+                ret_val.reserve(a.nnz());
+                for(std::size_t k = 0; k < a.nnz(); k++)
+                    ret_val.push_back(a.index(k), a.value(k) * b.at(a.index(k)));
+                return ret_val;
+            };
+
+            template<typename Range, typename T>
+            sparse_vector<T> mul(const Range& a, const sparse_range<T>& b){
+                return mul(b, a);
+            };
+
+            template<typename T>
+            sparse_vector<T> mul(const sparse_range<T>& a, const sparse_range<T>& b){
+                detail::check_sizes(a.size(), b.size());
+                sparse_vector<T> ret_val(a.size());
+                std::size_t i = 0, j = 0;
+                while((i < a.nnz()) && (j < b.nnz())){
+                    if(a.index(i) < b.index(j)){
+                        i++;
+                    }else if(b.index(j) < a.index(i)){
+                        j++;
+                    }else{
+                        ret_val.push_back(a.index(i), a.value(i) * b.value(j));
+                        i++;
+                        j++;
+                    };
+                };
+                return ret_val;
+            };
+
+            // out += r touching only the stored entries, e.g.
+            // scatter_add(x, scalar_mul(-alpha, g)) for a sparse gradient g
+            template<typename Out, typename T>
+            void scatter_add(Out& out, const sparse_range<T>& r){
+                detail::check_sizes(out.size(), r.size());
+                for(std::size_t k = 0; k < r.nnz(); k++) out[r.index(k)] += r.value(k);
+            };
+
+            template<typename Out, typename T>
+            void assign(Out& out, const sparse_range<T>& r){
+                if(out.size() != r.size())
+                    throw std::length_error("Output should have same length with range");
+                std::fill(out.begin(), out.end(), T(0));
+                scatter_add(out, r);
+            };
+
+            template<typename T, typename Range>
+            T dot(const sparse_range<T>& a, const Range& b){
+                detail::check_sizes(a.size(), b.size());
+                T ret_val(0);
+                for(std::size_t k = 0; k < a.nnz(); k++) ret_val += a.value(k) * b.at(a.index(k));
+                return ret_val;
+            };
+
+            template<typename Range, typename T>
+            T dot(const Range& a, const sparse_range<T>& b){
+                return dot(b, a);
+            };
+
+            template<typename T>
+            T dot(const sparse_range<T>& a, const sparse_range<T>& b){
+                detail::check_sizes(a.size(), b.size());
+                T ret_val(0);
+                std::size_t i = 0, j = 0;
+                while((i < a.nnz()) && (j < b.nnz())){
+                    if(a.index(i) < b.index(j)){
+                        i++;
+                    }else if(b.index(j) < a.index(i)){
+                        j++;
+                    }else{
+                        ret_val += a.value(i++) * b.value(j++);
+                    };
+                };
+                return ret_val;
+            };
+
+            // Sum of all elements
+            template<typename T>
+            T total(const sparse_range<T>& r){
+                T ret_val(0);
+                for(std::size_t k = 0; k < r.nnz(); k++) ret_val += r.value(k);
+                return ret_val;
+            };
+
+            template<typename T>
+            T norm(const sparse_range<T>& r){
+                T ret_val(0);
+                for(std::size_t k = 0; k < r.nnz(); k++) ret_val += r.value(k) * r.value(k);
+                return std::sqrt(ret_val);
+            };
+        };
+    };
+};
+
+#endif
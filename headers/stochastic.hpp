@@ -0,0 +1,169 @@
+#ifndef STOCHASTIC
+#define STOCHASTIC
+
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <exception>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <operations.hpp>
+#include <parallel.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace stochastic{
+        using rv = double;
+        using vec = std::vector<double>;
+        using index = std::vector<std::size_t>;
+        using index_range = ranges::const_range<index>;
+
+        // Finite sums f(x) = (1 / N) sum_k f_k(x): f.term_count() returns N,
+        // f.eval_terms(x, idx, g) returns the sum of f_k(x) over k in idx
+        // (an index_range) and adds their gradients to g
+        struct params{
+            std::size_t batch = 256;
+            std::size_t max_epochs = 100;
+            rv rate = 1.e-2;
+            rv momentum = 0.9;
+            rv beta1 = 0.9;
+            rv beta2 = 0.999;
+            rv eps = 1.e-8;
+            // Bound on the norm of the full gradient, checked after each epoch
+            rv tol = 1.e-6;
+            std::size_t threads = parallel::hardware_threads();
+            std::uint64_t seed = 0;
+        };
+
+        // Term order, per-thread gradient accumulators and update buffers
+        struct workspace{
+            index order;
+            std::vector<vec> partial;
+            vec partial_values;
+            vec g, full, anchor, g_anchor, m, v;
+            workspace(const std::size_t terms, const std::size_t n, const std::size_t threads):
+                order(terms),
+                partial(threads, vec(n)),
+                partial_values(threads),
+                g(n), full(n), anchor(n), g_anchor(n), m(n, 0.), v(n, 0.)
+                {
+                    std::iota(order.begin(), order.end(), 0);
+                };
+        };
+
+        // Mean value and gradient over order[beg, end): one contiguous share
+        // of the indices per thread, partial sums reduced afterwards
+        template<typename Func>
+        rv batch_gradient(const Func& f, const vec& x, const std::size_t beg, const std::size_t end,
+                workspace& ws, parallel::team& tm, vec& g){
+            const std::size_t count = end - beg, tn = tm.size();
+            const std::size_t chunk = (count + tn - 1) / tn;
+            tm.run([&](const std::size_t t){
+                vec& acc = ws.partial[t];
+                std::fill(acc.begin(), acc.end(), 0.);
+                const std::size_t b = std::min(end, beg + t * chunk), e = std::min(end, b + chunk);
+                ws.partial_values[t] = (b < e) ? f.eval_terms(x,
+                    index_range(ws.order.cbegin() + b, ws.order.cbegin() + e), acc) : 0.;
+            });
+            const rv scale = 1. / static_cast<rv>(count);
+            std::fill(g.begin(), g.end(), 0.);
+            rv value = 0.;
+            for(std::size_t t = 0; t < tn; t++){
+                value += ws.partial_values[t];
+                const auto acc = ranges::const_range(ws.partial[t]);
+                ranges::ops::assign(g, ranges::ops::sum(ranges::const_range(g), acc));
+            };
+            ranges::ops::assign(g, ranges::ops::scalar_mul(scale, ranges::const_range(g)));
+            return value * scale;
+        };
+
+        // Shuffled mini-batch epochs; step(beg, end) updates x from one batch,
+        // epoch() runs after the full gradient at x is known
+        template<typename Func, typename Step, typename Epoch>
+        grad::min_result_nd run(const Func& f, vec& x, const params& p, workspace& ws,
+                parallel::team& tm, const Step& step, const Epoch& epoch){
+            const std::size_t terms = f.term_count(), batch = std::max<std::size_t>(p.batch, 1);
+            if(terms == 0) throw std::length_error("Objective should have at least one term");
+            std::mt19937_64 gen(p.seed);
+            rv value = batch_gradient(f, x, 0, terms, ws, tm, ws.full);
+            for(std::size_t ep = 0; ep < p.max_epochs; ep++){
+                if(grad::norm(ws.full) < p.tol) return {true, x, value, ep};
+                epoch();
+                std::shuffle(ws.order.begin(), ws.order.end(), gen);
+                for(std::size_t beg = 0; beg < terms; beg += batch)
+                    step(beg, std::min(terms, beg + batch));
+                std::iota(ws.order.begin(), ws.order.end(), 0);
+                value = batch_gradient(f, x, 0, terms, ws, tm, ws.full);
+            };
+            return {grad::norm(ws.full) < p.tol, x, value, p.max_epochs};
+        };
+
+        // Heavy-ball SGD: v = momentum v - rate g, x = x + v
+        template<typename Func>
+        grad::min_result_nd sgd(const Func& f, const vec& x0, const params& p = {}){
+            using namespace ranges;
+            parallel::team tm(p.threads);
+            workspace ws(f.term_count(), x0.size(), tm.size());
+            vec x(x0);
+            const auto cx = const_range(x), cg = const_range(ws.g), cv = const_range(ws.v);
+            const auto step = [&](const std::size_t beg, const std::size_t end){
+                batch_gradient(f, x, beg, end, ws, tm, ws.g);
+                ops::assign(ws.v, ops::sub(ops::scalar_mul(p.momentum, cv), ops::scalar_mul(p.rate, cg)));
+                ops::assign(x, ops::sum(cx, cv));
+            };
+            return run(f, x, p, ws, tm, step, []{});
+        };
+
+        // Adam with bias-corrected step rate * m / (sqrt(v) + eps)
+        template<typename Func>
+        grad::min_result_nd adam(const Func& f, const vec& x0, const params& p = {}){
+            using namespace ranges;
+            parallel::team tm(p.threads);
+            workspace ws(f.term_count(), x0.size(), tm.size());
+            vec x(x0);
+            const auto cx = const_range(x), cg = const_range(ws.g),
+                       cm = const_range(ws.m), cv = const_range(ws.v);
+            rv b1t = 1., b2t = 1.;
+            const auto step = [&](const std::size_t beg, const std::size_t end){
+                batch_gradient(f, x, beg, end, ws, tm, ws.g);
+                b1t *= p.beta1;
+                b2t *= p.beta2;
+                const rv rate = p.rate * std::sqrt(1. - b2t) / (1. - b1t), eps = p.eps;
+                ops::assign(ws.m, ops::sum(ops::scalar_mul(p.beta1, cm), ops::scalar_mul(1. - p.beta1, cg)));
+                ops::assign(ws.v, ops::sum(ops::scalar_mul(p.beta2, cv),
+                    ops::scalar_mul(1. - p.beta2, ops::mul(cg, cg))));
+                ops::assign(x, ops::sub(cx, ops::zip([rate, eps](const rv m, const rv v){
+                    return rate * m / (std::sqrt(v) + eps);
+                }, cm, cv)));
+            };
+            return run(f, x, p, ws, tm, step, []{});
+        };
+
+        // SVRG: batch gradients at x and at the epoch anchor, corrected by
+        // the full gradient at the anchor
+        template<typename Func>
+        grad::min_result_nd svrg(const Func& f, const vec& x0, const params& p = {}){
+            using namespace ranges;
+            parallel::team tm(p.threads);
+            workspace ws(f.term_count(), x0.size(), tm.size());
+            vec x(x0);
+            const auto cx = const_range(x), cg = const_range(ws.g),
+                       ca = const_range(ws.g_anchor), cf = const_range(ws.full);
+            const auto step = [&](const std::size_t beg, const std::size_t end){
+                batch_gradient(f, x, beg, end, ws, tm, ws.g);
+                batch_gradient(f, ws.anchor, beg, end, ws, tm, ws.g_anchor);
+                ops::assign(ws.g, ops::sum(ops::sub(cg, ca), cf));
+                ops::assign(x, ops::sub(cx, ops::scalar_mul(p.rate, cg)));
+            };
+            const auto epoch = [&]{ ws.anchor = x; };
+            return run(f, x, p, ws, tm, step, epoch);
+        };
+    };
+};
+
+#endif
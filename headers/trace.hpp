@@ -0,0 +1,218 @@
+#ifndef TRACE
+#define TRACE
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <algorithm>
+#include <condition_variable>
+
+#include <cmath>
+#include <limits>
+
+#include <instrument.hpp>
+
+namespace minimize{
+    namespace trace{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        // File layout: header, then fixed-width records of
+        // iteration, evaluations (uint64), value, progress, step length
+        // and dim coordinates (double), all in host byte order
+        struct file_header{
+            std::uint64_t magic;
+            std::uint32_t version, dim;
+        };
+
+        constexpr std::uint64_t magic = 0x45434152544e494dull;
+        constexpr std::uint32_t version = 1;
+        constexpr std::size_t fixed_fields = 5;
+
+        inline std::size_t record_bytes(const std::size_t dim){
+            return (fixed_fields + dim) * sizeof(rv);
+        };
+
+        // Records are packed into one of two buffers; a full buffer is
+        // handed to a background thread that does all file output, so
+        // push() only copies bytes unless both buffers are full.
+        class writer{
+            protected:
+                const std::size_t _dim, _bytes, _capacity;
+                std::ofstream _out;
+                std::vector<char> _buffers[2];
+                std::size_t _active, _fill, _pending_bytes;
+                vec _last;
+                bool _has_last, _pending, _stop, _failed;
+                std::mutex _lock;
+                std::condition_variable _ready, _written;
+                std::thread _worker;
+                void work(void){
+                    std::unique_lock<std::mutex> lk(_lock);
+                    while(true){
+                        _ready.wait(lk, [this]{ return _pending || _stop; });
+                        if(!_pending) return;
+                        const char* data = _buffers[1 - _active].data();
+                        const std::size_t size = _pending_bytes;
+                        lk.unlock();
+                        _out.write(data, static_cast<std::streamsize>(size));
+                        const bool failed = !_out;
+                        lk.lock();
+                        _failed = _failed || failed;
+                        _pending = false;
+                        _written.notify_all();
+                    };
+                };
+                void hand_off(void){
+                    std::unique_lock<std::mutex> lk(_lock);
+                    _written.wait(lk, [this]{ return !_pending; });
+                    if(_failed) throw std::runtime_error("Trace output failed");
+                    _pending_bytes = _fill;
+                    _pending = true;
+                    _active = 1 - _active;
+                    _fill = 0;
+                    _ready.notify_one();
+                };
+            public:
+                writer(const std::string& path, const std::size_t dim, const std::size_t buffer_records = 4096):
+                    _dim(dim), _bytes(record_bytes(dim)), _capacity(std::max<std::size_t>(buffer_records, 1)),
+                    _out(path, std::ios::binary | std::ios::trunc),
+                    _active(0), _fill(0), _pending_bytes(0),
+                    _last(dim), _has_last(false), _pending(false), _stop(false), _failed(false)
+                    {
+                        if(!_out) throw std::runtime_error("Cannot open trace " + path);
+                        const file_header h{magic, version, static_cast<std::uint32_t>(dim)};
+                        _out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+                        _buffers[0].resize(_capacity * _bytes);
+                        _buffers[1].resize(_capacity * _bytes);
+                        _worker = std::thread(&writer::work, this);
+                    };
+                writer(const writer&) = delete;
+                writer& operator=(const writer&) = delete;
+                ~writer(){
+                    try{
+                        flush();
+                    }catch(...){};
+                    {
+                        std::lock_guard<std::mutex> lk(_lock);
+                        _stop = true;
+                    };
+                    _ready.notify_one();
+                    _worker.join();
+                };
+                std::size_t dim(void) const{
+                    return _dim;
+                };
+                // x holds dim coordinates or is null; the step length is
+                // measured from the previous pushed x
+                void push(const std::uint64_t iteration, const std::uint64_t evaluations,
+                        const rv value, const rv progress, const rv* x){
+                    if(_fill == _capacity * _bytes) hand_off();
+                    rv step = std::numeric_limits<rv>::quiet_NaN();
+                    if(x != nullptr){
+                        if(_has_last){
+                            rv sq = 0.;
+                            for(std::size_t i = 0; i < _dim; i++) sq += (x[i] - _last[i]) * (x[i] - _last[i]);
+                            step = std::sqrt(sq);
+                        };
+                        std::memcpy(_last.data(), x, _dim * sizeof(rv));
+                        _has_last = true;
+                    };
+                    char* out = _buffers[_active].data() + _fill;
+                    std::memcpy(out, &iteration, sizeof(iteration));
+                    std::memcpy(out + 8, &evaluations, sizeof(evaluations));
+                    const rv fields[3] = {value, progress, step};
+                    std::memcpy(out + 16, fields, sizeof(fields));
+                    if(x != nullptr){
+                        std::memcpy(out + 40, x, _dim * sizeof(rv));
+                    }else{
+                        const rv nan = std::numeric_limits<rv>::quiet_NaN();
+                        for(std::size_t i = 0; i < _dim; i++) std::memcpy(out + 40 + i * sizeof(rv), &nan, sizeof(rv));
+                    };
+                    _fill += _bytes;
+                };
+                // Blocks until every pushed record has reached the file
+                void flush(void){
+                    if(_fill > 0) hand_off();
+                    std::unique_lock<std::mutex> lk(_lock);
+                    _written.wait(lk, [this]{ return !_pending; });
+                    _out.flush();
+                    if(_failed || !_out) throw std::runtime_error("Trace output failed");
+                };
+        };
+
+        // Instrumentation policy streaming every iteration event into a
+        // writer together with the running evaluation count
+        class policy{
+            protected:
+                writer& _writer;
+                std::uint64_t _evaluations;
+            public:
+                explicit policy(writer& w): _writer(w), _evaluations(0) {};
+                void evaluation(void){
+                    _evaluations++;
+                };
+                void begin(const instrument::phase){};
+                void end(const instrument::phase){};
+                void iteration(const instrument::event& e){
+                    _writer.push(e.step, _evaluations, e.value, e.progress, e.x);
+                };
+                std::uint64_t evaluations(void) const{
+                    return _evaluations;
+                };
+        };
+
+        struct record{
+            std::uint64_t iteration, evaluations;
+            rv value, progress, step;
+            vec x;
+        };
+
+        inline std::vector<record> read(const std::string& path){
+            std::ifstream in(path, std::ios::binary);
+            if(!in) throw std::runtime_error("Cannot open trace " + path);
+            file_header h;
+            in.read(reinterpret_cast<char*>(&h), sizeof(h));
+            if(!in || (h.magic != magic) || (h.version != version))
+                throw std::logic_error(path + " is not a trace");
+            std::vector<char> buffer(record_bytes(h.dim));
+            std::vector<record> ret_val;
+            while(in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))){
+                record r{0, 0, 0., 0., 0., vec(h.dim)};
+                const char* p = buffer.data();
+                std::memcpy(&r.iteration, p, 8);
+                std::memcpy(&r.evaluations, p + 8, 8);
+                std::memcpy(&r.value, p + 16, 8);
+                std::memcpy(&r.progress, p + 24, 8);
+                std::memcpy(&r.step, p + 32, 8);
+                std::memcpy(r.x.data(), p + 40, h.dim * sizeof(rv));
+                ret_val.push_back(std::move(r));
+            };
+            return ret_val;
+        };
+
+        // One line per record: iteration,evaluations,value,progress,step,x0,...
+        inline void to_csv(const std::string& path, std::ostream& out){
+            const std::vector<record> records = read(path);
+            const std::size_t dim = records.empty() ? 0 : records.front().x.size();
+            out << "iteration,evaluations,value,progress,step";
+            for(std::size_t i = 0; i < dim; i++) out << ",x" << i;
+            out << "\n";
+            out.precision(17);
+            for(const record& r : records){
+                out << r.iteration << "," << r.evaluations << "," << r.value << ","
+                    << r.progress << "," << r.step;
+                for(const rv xi : r.x) out << "," << xi;
+                out << "\n";
+            };
+        };
+    };
+};
+
+#endif
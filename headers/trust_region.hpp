@@ -0,0 +1,156 @@
+#ifndef TRUST_REGION
+#define TRUST_REGION
+
+#include <vector>
+
+#include <cmath>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <grad_minimize.hpp>
+
+namespace minimize{
+    namespace trust_region{
+        using rv = double;
+        using vec = std::vector<double>;
+
+        struct params{
+            rv tol = 1.e-6;
+            std::size_t max_steps = 256;
+            rv h = 1.e-5;
+            rv radius = 1.;
+            rv max_radius = 1.e+4;
+            rv min_radius = 1.e-12;
+            rv eta = 1.e-4;
+        };
+
+        inline void mat_vec(const vec& b, const vec& x, vec& out){
+            const std::size_t n = x.size();
+            for(std::size_t i = 0; i < n; i++)
+                out[i] = std::inner_product(x.cbegin(), x.cend(), b.cbegin() + i * n, 0.);
+        };
+
+        // Smallest tau >= 0 with |z + tau * d| = radius
+        inline rv to_boundary(const vec& z, const vec& d, const rv radius){
+            const rv a = grad::dot(d, d), b = 2. * grad::dot(z, d),
+                     c = grad::dot(z, z) - radius * radius;
+            return (- b + std::sqrt(std::max(b * b - 4. * a * c, 0.))) / (2. * a);
+        };
+
+        // Steihaug truncated CG for min g.p + p.B.p / 2 s.t. |p| <= radius
+        inline vec steihaug(const vec& b, const vec& g, const rv radius){
+            const std::size_t n = g.size();
+            vec z(n, 0.), r(g), d(n), bd(n);
+            std::transform(g.cbegin(), g.cend(), d.begin(), std::negate<rv>());
+            const rv gn = grad::norm(g);
+            const rv eps = std::min(0.5, std::sqrt(gn)) * gn;
+            rv rr = grad::dot(r, r);
+            for(std::size_t step = 0; (step < 2 * n) && (std::sqrt(rr) > eps); step++){
+                mat_vec(b, d, bd);
+                const rv dbd = grad::dot(d, bd);
+                if(dbd <= 0.){
+                    const rv tau = to_boundary(z, d, radius);
+                    for(std::size_t i = 0; i < n; i++) z[i] += tau * d[i];
+                    return z;
+                };
+                const rv a = rr / dbd;
+                rv zz = 0.;
+                for(std::size_t i = 0; i < n; i++) zz += (z[i] + a * d[i]) * (z[i] + a * d[i]);
+                if(std::sqrt(zz) >= radius){
+                    const rv tau = to_boundary(z, d, radius);
+                    for(std::size_t i = 0; i < n; i++) z[i] += tau * d[i];
+                    return z;
+                };
+                for(std::size_t i = 0; i < n; i++){
+                    z[i] += a * d[i];
+                    r[i] += a * bd[i];
+                };
+                const rv rrn = grad::dot(r, r);
+                for(std::size_t i = 0; i < n; i++) d[i] = - r[i] + (rrn / rr) * d[i];
+                rr = rrn;
+            };
+            return z;
+        };
+
+        // derivs(x) returns the gradient and row-major Hessian at x; one
+        // callable as derivs(x, value) is also handed the known f(x)
+        template<typename Func, typename Derivs>
+        grad::min_result_nd newton_minimize(const Func& f, const Derivs& derivs,
+                const vec& x0, const params& p){
+            const std::size_t n = x0.size();
+            const auto derive = [&derivs](const vec& x, const rv value){
+                if constexpr(std::is_invocable<const Derivs&, const vec&, rv>::value){
+                    return derivs(x, value);
+                }else{
+                    return derivs(x);
+                };
+            };
+            vec x(x0), xn(n), bs(n);
+            rv radius = p.radius;
+            rv value = f(ranges::const_range(x));
+            auto gh = derive(x, value);
+            for(std::size_t step = 0; step < p.max_steps; step++){
+                const vec& g = gh.first;
+                const vec& b = gh.second;
+                if(grad::norm(g) < p.tol) return {true, x, value, step};
+                if(radius < p.min_radius) return {false, x, value, step};
+                const vec s = steihaug(b, g, radius);
+                mat_vec(b, s, bs);
+                const rv pred = - (grad::dot(g, s) + 0.5 * grad::dot(s, bs));
+                for(std::size_t i = 0; i < n; i++) xn[i] = x[i] + s[i];
+                const rv vn = f(ranges::const_range(xn));
+                const rv rho = (pred > 0.) ? (value - vn) / pred : -1.;
+                const rv sn = grad::norm(s);
+                if(rho < 0.25){
+                    radius = 0.25 * sn;
+                }else if((rho > 0.75) && (sn >= 0.99 * radius)){
+                    radius = std::min(2. * radius, p.max_radius);
+                };
+                if(rho > p.eta){
+                    std::swap(x, xn);
+                    value = vn;
+                    gh = derive(x, value);
+                };
+            };
+            return {grad::norm(gh.first) < p.tol, x, value, p.max_steps};
+        };
+
+        // Gradient and Hessian both from shared finite differences, or the
+        // Hessian from differences of an analytic gradient
+        template<typename Func>
+        grad::min_result_nd newton_minimize(const Func& f, const vec& x0,
+                const params& p = {}){
+            if constexpr(derivate::has_value_and_gradient<Func>::value){
+                const auto derivs = [&](const vec& x){
+                    return std::pair<vec, vec>{grad::gradient(f, x, p.h),
+                        derivate::gradient_hessian(f, x, p.h)};
+                };
+                return newton_minimize(f, derivs, x0, p);
+            }else{
+                const auto derivs = [&](const vec& x, const rv value){
+                    return derivate::auto_grad_hessian(f, ranges::const_range(x), value, p.h);
+                };
+                return newton_minimize(f, derivs, x0, p);
+            };
+        };
+
+        // Exact Hessian callback: hess(range, out) fills a row-major n x n matrix
+        template<typename Func, typename Hess>
+        grad::min_result_nd newton_minimize_hessian(const Func& f, const Hess& hess,
+                const vec& x0, const params& p = {}){
+            const std::size_t n = x0.size();
+            const auto derivs = [&](const vec& x){
+                const auto xr = ranges::const_range(x);
+                std::pair<vec, vec> ret_val{grad::gradient(f, x, 1.e-8), vec(n * n)};
+                hess(xr, ret_val.second);
+                return ret_val;
+            };
+            return newton_minimize(f, derivs, x0, p);
+        };
+    };
+};
+
+#endif
\ No newline at end of file
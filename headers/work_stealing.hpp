@@ -0,0 +1,99 @@
+#ifndef WORK_STEALING
+#define WORK_STEALING
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <exception>
+#include <functional>
+
+#include <parallel.hpp>
+
+namespace minimize{
+    namespace parallel{
+        // Each worker owns a deque: it pops its own tasks from the back
+        // and steals from the front of the others when it runs dry
+        class work_stealing_pool{
+            public:
+                using task = std::function<void(const std::size_t)>;
+            protected:
+                struct queue{
+                    std::mutex lock;
+                    std::deque<task> tasks;
+                };
+                std::vector<std::unique_ptr<queue> > _queues;
+                std::atomic<std::size_t> _pending{0}, _next{0};
+                bool pop(const std::size_t w, task& t){
+                    queue& q = *_queues[w];
+                    std::lock_guard<std::mutex> guard(q.lock);
+                    if(q.tasks.empty()) return false;
+                    t = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                    return true;
+                };
+                bool steal(const std::size_t w, task& t){
+                    for(std::size_t k = 1; k < _queues.size(); k++){
+                        queue& q = *_queues[(w + k) % _queues.size()];
+                        std::lock_guard<std::mutex> guard(q.lock);
+                        if(q.tasks.empty()) continue;
+                        t = std::move(q.tasks.front());
+                        q.tasks.pop_front();
+                        return true;
+                    };
+                    return false;
+                };
+                // A throwing task still counts as done; worker w keeps the
+                // first exception it meets in error
+                void work(const std::size_t w, std::exception_ptr& error){
+                    task t;
+                    while(_pending.load() > 0){
+                        if(pop(w, t) || steal(w, t)){
+                            try{
+                                t(w);
+                            }catch(...){
+                                if(!error) error = std::current_exception();
+                            };
+                            _pending--;
+                        }else{
+                            std::this_thread::yield();
+                        };
+                    };
+                };
+            public:
+                explicit work_stealing_pool(const std::size_t threads = hardware_threads()){
+                    for(std::size_t w = 0; w < std::max<std::size_t>(threads, 1); w++)
+                        _queues.emplace_back(new queue());
+                };
+                std::size_t size(void) const{
+                    return _queues.size();
+                };
+                // Tasks may push further tasks onto their own worker's queue
+                void push(task t, const std::size_t w){
+                    _pending++;
+                    queue& q = *_queues[w % _queues.size()];
+                    std::lock_guard<std::mutex> guard(q.lock);
+                    q.tasks.push_back(std::move(t));
+                };
+                void push(task t){
+                    push(std::move(t), _next++);
+                };
+                // Runs until every pushed task, including nested ones, is done,
+                // then rethrows the first exception any task threw
+                void run(void){
+                    std::vector<std::exception_ptr> errors(_queues.size());
+                    std::vector<std::thread> pool;
+                    for(std::size_t w = 1; w < _queues.size(); w++)
+                        pool.emplace_back([this, w, &error = errors[w]](void){ work(w, error); });
+                    work(0, errors[0]);
+                    for(auto& th : pool) th.join();
+                    detail::rethrow_first(errors);
+                };
+        };
+    };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,121 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE AsyncEvaluate
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <stdexcept>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <async_evaluate.hpp>
+#include <differential_evolution.hpp>
+
+BOOST_AUTO_TEST_SUITE(AsyncEvaluateTests)
+
+struct shifted_quadratic{
+    mutable std::atomic<std::size_t> calls{0};
+    template<typename Range>
+    double operator()(const Range& r) const{
+        calls++;
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++){
+            const double d = r.at(i) - 0.5 * static_cast<double>(i);
+            ret_val += static_cast<double>(i + 1) * d * d;
+        };
+        return ret_val;
+    };
+};
+
+struct rosenbrock{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        const double a = 1. - r.at(0), b = r.at(1) - r.at(0) * r.at(0);
+        return a * a + 100. * b * b;
+    };
+};
+
+struct failing{
+    template<typename Range>
+    double operator()(const Range&) const{
+        throw std::runtime_error("solver failed");
+    };
+};
+
+BOOST_AUTO_TEST_CASE(GradientMatchesSerial)
+{
+    const shifted_quadratic f;
+    const minimize::async::threaded_objective<shifted_quadratic> af(f, 4);
+    const std::vector<double> x{0.3, -1.2, 2.5};
+    const auto g = minimize::async::sync_wait(minimize::async::auto_grad(af, x, 1.e-4));
+    const auto e = minimize::derivate::auto_grad(f, minimize::ranges::const_range(x), 1.e-4);
+    for(std::size_t i = 0; i < x.size(); i++)
+        BOOST_CHECK_CLOSE(g[i], e[i], 1.e-6);
+}
+
+BOOST_AUTO_TEST_CASE(GradientOverlapsLatency)
+{
+    const shifted_quadratic f;
+    const auto latency = std::chrono::milliseconds(20);
+    const minimize::async::threaded_objective<shifted_quadratic> af(f, 16, latency);
+    const std::vector<double> x(4, 1.);
+    const auto start = std::chrono::steady_clock::now();
+    minimize::async::sync_wait(minimize::async::auto_grad(af, x, 1.e-4));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    BOOST_CHECK_EQUAL(f.calls.load(), 16);
+    BOOST_CHECK(elapsed < 8 * latency);
+}
+
+BOOST_AUTO_TEST_CASE(NelderMeadRosenbrock)
+{
+    const rosenbrock f;
+    const minimize::async::threaded_objective<rosenbrock> af(f, 4);
+    for(const bool speculative : {true, false}){
+        const auto res = minimize::async::sync_wait(
+            minimize::async::nelder_mead_minimize(af, {-1.2, 1.}, {}, speculative));
+        BOOST_CHECK(res.status);
+        BOOST_CHECK_CLOSE(res.x[0], 1., 1.e-3);
+        BOOST_CHECK_CLOSE(res.x[1], 1., 1.e-3);
+    };
+}
+
+BOOST_AUTO_TEST_CASE(BFGSQuadratic)
+{
+    const shifted_quadratic f;
+    const minimize::async::threaded_objective<shifted_quadratic> af(f, 8);
+    minimize::grad::params p;
+    p.h = 1.e-5;
+    const auto res = minimize::async::sync_wait(
+        minimize::async::bfgs_minimize(af, std::vector<double>(4, 2.), p));
+    BOOST_CHECK(res.status);
+    for(std::size_t i = 0; i < res.x.size(); i++)
+        BOOST_CHECK_SMALL(res.x[i] - 0.5 * static_cast<double>(i), 1.e-5);
+}
+
+BOOST_AUTO_TEST_CASE(PopulationThroughBlockingEvaluator)
+{
+    const shifted_quadratic f;
+    const minimize::async::threaded_objective<shifted_quadratic> af(f, 4);
+    const minimize::async::blocking_evaluator<decltype(af)> eval(af);
+    const minimize::box::bounds b{std::vector<double>(2, -3.), std::vector<double>(2, 3.)};
+    minimize::differential_evolution::population pop(20, 2);
+    minimize::differential_evolution::params p;
+    p.seed = 5;
+    const auto res = minimize::differential_evolution::minimize_batched(eval, b, pop, p);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_SMALL(res.x[0], 1.e-4);
+    BOOST_CHECK_SMALL(res.x[1] - 0.5, 1.e-4);
+}
+
+BOOST_AUTO_TEST_CASE(ErrorsReachAwaiter)
+{
+    const failing f;
+    const minimize::async::threaded_objective<failing> af(f, 2);
+    const std::vector<double> x{1., 2.};
+    BOOST_CHECK_THROW(minimize::async::sync_wait(minimize::async::auto_grad(af, x)),
+        std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
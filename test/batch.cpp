@@ -0,0 +1,74 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Batch
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <batch.hpp>
+
+BOOST_AUTO_TEST_SUITE(BatchTests)
+
+struct shift{
+    double c;
+};
+
+struct shifted_rosenbrock{
+    template<typename Range>
+    double operator()(const Range& r, const shift& s) const{
+        double ret_val = 0.;
+        for(std::size_t i = 0; i + 1 < r.size(); i++){
+            const double u = r.at(i) - s.c, v = r.at(i + 1) - s.c;
+            const double t = v - u * u;
+            ret_val += (1. - u) * (1. - u) + 10. * t * t;
+        };
+        return ret_val;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(FixedBFGS)
+{
+    const auto f = [](const auto& r){
+        const double a = 1. - r.at(0), b = r.at(1) - r.at(0) * r.at(0);
+        return a * a + 100. * b * b;
+    };
+    minimize::batch::point<2> x{-1.2, 1.};
+    const auto res = minimize::batch::fixed::bfgs_minimize<2>(f, x);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(x[0], 1., 1.e-3);
+    BOOST_CHECK_CLOSE(x[1], 1., 1.e-3);
+}
+
+BOOST_AUTO_TEST_CASE(ManyInstances)
+{
+    constexpr std::size_t n = 4, count = 2000;
+    const shifted_rosenbrock f;
+    std::vector<shift> prms(count);
+    std::vector<double> starts(count * n, 0.), xs(count * n);
+    std::vector<minimize::batch::instance_result> results(count);
+    for(std::size_t i = 0; i < count; i++)
+        prms[i] = {0.0005 * static_cast<double>(i)};
+    minimize::batch::minimize<n>(f, starts, prms, xs, results, {}, 4);
+    for(std::size_t i = 0; i < count; i++){
+        BOOST_CHECK(results[i].status);
+        for(std::size_t j = 0; j < n; j++)
+            BOOST_CHECK_LE(std::abs(xs[i * n + j] - 1. - prms[i].c), 1.e-5);
+    };
+}
+
+BOOST_AUTO_TEST_CASE(RuntimeDimension)
+{
+    const std::size_t n = 3, count = 64;
+    const shifted_rosenbrock f;
+    const std::vector<shift> prms(count, shift{0.5});
+    std::vector<double> starts(count * n, 0.), xs(count * n), ys(count * n);
+    std::vector<minimize::batch::instance_result> rd(count), rs(count);
+    minimize::batch::minimize_dynamic(n, f, starts, prms, xs, rd, {}, 2);
+    minimize::batch::minimize<3>(f, starts, prms, ys, rs, {}, 1);
+    for(std::size_t i = 0; i < count * n; i++)
+        BOOST_CHECK_EQUAL(xs[i], ys[i]);
+    BOOST_CHECK_THROW(minimize::batch::minimize_dynamic(
+        minimize::batch::max_dim + 1, f, starts, prms, xs, rd), std::length_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
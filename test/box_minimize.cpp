@@ -0,0 +1,61 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BoxMinimize
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <box_minimize.hpp>
+
+BOOST_AUTO_TEST_SUITE(BoxMinimizeTests)
+
+struct guarded_rosenbrock{
+    std::vector<double> lower, upper;
+    mutable std::size_t violations = 0;
+    template<typename Range>
+    double operator()(const Range& r) const{
+        for(std::size_t i = 0; i < r.size(); i++)
+            if((r.at(i) < lower.at(i)) || (r.at(i) > upper.at(i))) violations++;
+        const double a = 1. - r.at(0), b = r.at(1) - r.at(0) * r.at(0);
+        return a * a + 100. * b * b;
+    };
+};
+
+struct shifted_sphere{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++){
+            const double t = r.at(i) - 2. * static_cast<double>(i) + 3.;
+            ret_val += t * t;
+        };
+        return ret_val;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(ActiveUpperBound)
+{
+    const minimize::box::bounds b{{-2., -2.}, {0.5, 2.}};
+    const guarded_rosenbrock f{b.lower, b.upper};
+    const std::vector<double> x0{-1.2, 1.};
+    const auto res = minimize::box::minimize(f, x0, b);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 0.5, 1.e-4);
+    BOOST_CHECK_CLOSE(res.x.at(1), 0.25, 1.e-3);
+    BOOST_CHECK_EQUAL(f.violations, 0);
+}
+
+BOOST_AUTO_TEST_CASE(MixedBounds)
+{
+    const shifted_sphere f;
+    const minimize::box::bounds b{{0., 0., 0., 0.}, {1., 1., 1., 1.}};
+    const std::vector<double> x0{5., -5., 0.5, 0.5};
+    const auto res = minimize::box::minimize(f, x0, b);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_EQUAL(res.x.at(0), 0.);
+    BOOST_CHECK_EQUAL(res.x.at(1), 0.);
+    BOOST_CHECK_CLOSE(res.x.at(2), 1., 1.e-4);
+    BOOST_CHECK_CLOSE(res.x.at(3), 1., 1.e-4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,153 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Checkpoint
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include <checkpoint.hpp>
+
+BOOST_AUTO_TEST_SUITE(CheckpointTests)
+
+struct counted_rosenbrock{
+    mutable std::size_t calls = 0;
+    template<typename Range>
+    double operator()(const Range& r) const{
+        calls++;
+        const double a = 1. - r.at(0), b = r.at(1) - r.at(0) * r.at(0);
+        return a * a + 100. * b * b;
+    };
+};
+
+struct counted_cosine{
+    mutable std::size_t calls = 0;
+    double operator()(const double x) const{
+        calls++;
+        return std::cos(x);
+    };
+};
+
+struct temp_path{
+    const std::string path;
+    explicit temp_path(const std::string& name):
+        path((std::filesystem::temp_directory_path() / name).string())
+        {
+            std::filesystem::remove(path);
+        };
+    ~temp_path(){
+        std::filesystem::remove(path);
+    };
+};
+
+BOOST_AUTO_TEST_CASE(GoldenResume)
+{
+    using namespace minimize;
+    const temp_path tmp("minimize_golden.ckpt");
+    const counted_cosine ref;
+    const auto expected = D1::golden_ratio_minimize(ref, {2., 5.}, 1.e-8, 1024);
+    const counted_cosine f;
+    {
+        checkpoint::mapped_file file(tmp.path, checkpoint::kind::golden, checkpoint::golden_size);
+        const auto part = checkpoint::golden_ratio_minimize(f, {2., 5.}, 1.e-8, 10, file);
+        BOOST_CHECK(!part.first);
+    };
+    checkpoint::mapped_file file(tmp.path, checkpoint::kind::golden, checkpoint::golden_size);
+    BOOST_CHECK_EQUAL(file.step(), 10);
+    const auto res = checkpoint::golden_ratio_minimize(f, {2., 5.}, 1.e-8, 1024, file);
+    BOOST_CHECK(res.first);
+    BOOST_CHECK_EQUAL(res.second, expected.second);
+    BOOST_CHECK_EQUAL(f.calls, ref.calls);
+}
+
+BOOST_AUTO_TEST_CASE(BFGSResume)
+{
+    using namespace minimize;
+    const temp_path tmp("minimize_bfgs.ckpt");
+    const std::vector<double> x0{-1.2, 1.};
+    const counted_rosenbrock ref;
+    const auto expected = grad::bfgs_minimize(ref, x0);
+    grad::params p;
+    p.max_steps = 7;
+    const counted_rosenbrock f;
+    {
+        checkpoint::mapped_file file(tmp.path, checkpoint::kind::bfgs, checkpoint::bfgs_size(2));
+        const auto part = checkpoint::bfgs_minimize(f, x0, p, file);
+        BOOST_CHECK(!part.status);
+    };
+    p.max_steps = grad::params{}.max_steps;
+    checkpoint::mapped_file file(tmp.path, checkpoint::kind::bfgs, checkpoint::bfgs_size(2));
+    const auto res = checkpoint::bfgs_minimize(f, x0, p, file);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_EQUAL(res.steps, expected.steps);
+    BOOST_CHECK_EQUAL(res.x[0], expected.x[0]);
+    BOOST_CHECK_EQUAL(res.x[1], expected.x[1]);
+    BOOST_CHECK_EQUAL(f.calls, ref.calls);
+}
+
+BOOST_AUTO_TEST_CASE(NelderMeadResume)
+{
+    using namespace minimize;
+    const temp_path tmp("minimize_nm.ckpt");
+    const std::vector<double> x0{-1.2, 1.};
+    const counted_rosenbrock ref;
+    const auto expected = nelder_mead::minimize(ref, x0);
+    nelder_mead::params p;
+    p.max_steps = 40;
+    const counted_rosenbrock f;
+    {
+        checkpoint::mapped_file file(tmp.path, checkpoint::kind::nelder_mead, checkpoint::nelder_mead_size(2));
+        checkpoint::nelder_mead_minimize(f, x0, p, file);
+    };
+    p.max_steps = nelder_mead::params{}.max_steps;
+    checkpoint::mapped_file file(tmp.path, checkpoint::kind::nelder_mead, checkpoint::nelder_mead_size(2));
+    const auto res = checkpoint::nelder_mead_minimize(f, x0, p, file);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_EQUAL(res.steps, expected.steps);
+    BOOST_CHECK_EQUAL(res.x[0], expected.x[0]);
+    BOOST_CHECK_EQUAL(res.x[1], expected.x[1]);
+    BOOST_CHECK_EQUAL(f.calls, ref.calls);
+}
+
+BOOST_AUTO_TEST_CASE(UncommittedStageIgnored)
+{
+    using namespace minimize;
+    const temp_path tmp("minimize_stage.ckpt");
+    {
+        checkpoint::mapped_file file(tmp.path, checkpoint::kind::golden, checkpoint::golden_size);
+        BOOST_CHECK(file.empty());
+        file.stage()[0] = 1.;
+        file.commit(3, 1);
+        file.stage()[0] = 2.;
+    };
+    checkpoint::mapped_file file(tmp.path, checkpoint::kind::golden, checkpoint::golden_size);
+    BOOST_CHECK(!file.empty());
+    BOOST_CHECK_EQUAL(file.step(), 3);
+    BOOST_CHECK_EQUAL(file.size(), 1);
+    BOOST_CHECK_EQUAL(file.state()[0], 1.);
+    BOOST_CHECK_THROW(checkpoint::mapped_file(tmp.path, checkpoint::kind::bfgs, checkpoint::golden_size),
+        std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(OtherDimensionRejected)
+{
+    using namespace minimize;
+    const temp_path tmp("minimize_dims.ckpt");
+    const counted_rosenbrock f;
+    grad::params p;
+    p.max_steps = 3;
+    checkpoint::mapped_file file(tmp.path, checkpoint::kind::bfgs, 200);
+    checkpoint::bfgs_minimize(f, {-1.2, 1., 0.5}, p, file);
+    BOOST_CHECK_THROW(checkpoint::bfgs_minimize(f, std::vector<double>(10, 0.5), p, file),
+        std::logic_error);
+    const temp_path nm_tmp("minimize_nm_dims.ckpt");
+    nelder_mead::params nm;
+    nm.max_steps = 3;
+    checkpoint::mapped_file nm_file(nm_tmp.path, checkpoint::kind::nelder_mead, 200);
+    checkpoint::nelder_mead_minimize(f, {-1.2, 1.}, nm, nm_file);
+    BOOST_CHECK_THROW(checkpoint::nelder_mead_minimize(f, {-1.2, 1., 0.5}, nm, nm_file),
+        std::logic_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
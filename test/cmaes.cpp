@@ -0,0 +1,72 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CMAES
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <cmaes.hpp>
+
+BOOST_AUTO_TEST_SUITE(CMAESTests)
+
+struct rotated_ellipsoid{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++){
+            double s = 0.;
+            for(std::size_t j = 0; j <= i; j++) s += r.at(j) - 1.;
+            ret_val += s * s;
+        };
+        return ret_val;
+    };
+};
+
+struct rosenbrock{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        const double a = 1. - r.at(0), b = r.at(1) - r.at(0) * r.at(0);
+        return a * a + 100. * b * b;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(JacobiEigen)
+{
+    const std::size_t n = 3;
+    std::vector<double> a{4., 1., 2., 1., 3., 0., 2., 0., 5.}, a0(a), v(n * n), w(n);
+    minimize::cmaes::jacobi_eigen(a, n, v, w);
+    for(std::size_t i = 0; i < n; i++)
+        for(std::size_t j = 0; j < n; j++){
+            double s = 0.;
+            for(std::size_t k = 0; k < n; k++) s += v[i * n + k] * w[k] * v[j * n + k];
+            BOOST_CHECK_CLOSE(s + 1., a0[i * n + j] + 1., 1.e-8);
+        };
+}
+
+BOOST_AUTO_TEST_CASE(RotatedEllipsoid)
+{
+    const rotated_ellipsoid f;
+    const std::vector<double> x0(6, 0.);
+    const auto res = minimize::cmaes::minimize(f, x0, {}, 2);
+    BOOST_CHECK(res.status);
+    for(const auto x : res.x)
+        BOOST_CHECK_CLOSE(x, 1., 1.e-3);
+}
+
+BOOST_AUTO_TEST_CASE(Rosenbrock)
+{
+    const rosenbrock f;
+    const std::vector<double> x0{-1.2, 1.};
+    minimize::cmaes::params p;
+    p.seed = 11;
+    minimize::cmaes::state s(x0, p);
+    const double* points = s.points.data();
+    const minimize::evaluate::serial_evaluator<rosenbrock> eval(f);
+    const auto res = minimize::cmaes::minimize_batched(eval, s, p);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 1., 1.e-3);
+    BOOST_CHECK_CLOSE(res.x.at(1), 1., 1.e-3);
+    BOOST_CHECK_EQUAL(points, s.points.data());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
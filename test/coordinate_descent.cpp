@@ -0,0 +1,80 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CoordinateDescent
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+#include <coordinate_descent.hpp>
+
+BOOST_AUTO_TEST_SUITE(CoordinateDescentTests)
+
+// Chain objective: sum (x_i - t_i)^2 + k sum (x_i - x_{i-1})^2; work counts
+// touched coordinates
+struct chain{
+    const double k = 0.3;
+    mutable std::size_t work = 0;
+    static double target(const std::size_t i){
+        return std::sin(static_cast<double>(i));
+    };
+    template<typename Range>
+    double operator()(const Range& r) const{
+        work += r.size();
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++){
+            const double t = r.at(i) - target(i);
+            ret_val += t * t;
+            if(i > 0){
+                const double d = r.at(i) - r.at(i - 1);
+                ret_val += k * d * d;
+            };
+        };
+        return ret_val;
+    };
+};
+
+struct chain_delta : chain{
+    double local(const std::vector<double>& x, const std::size_t i, const double v) const{
+        const double t = v - target(i);
+        double ret_val = t * t;
+        if(i > 0) ret_val += k * (v - x[i - 1]) * (v - x[i - 1]);
+        if(i + 1 < x.size()) ret_val += k * (x[i + 1] - v) * (x[i + 1] - v);
+        return ret_val;
+    };
+    double delta(const std::vector<double>& x, const std::size_t i, const double v) const{
+        work += 3;
+        return local(x, i, v) - local(x, i, x[i]);
+    };
+};
+
+static_assert(!minimize::coordinate::has_delta<chain>::value, "chain has no delta");
+static_assert(minimize::coordinate::has_delta<chain_delta>::value, "chain_delta has delta");
+
+BOOST_AUTO_TEST_CASE(FullEvaluation)
+{
+    const chain f;
+    const std::vector<double> x0(8, 0.);
+    const auto res = minimize::coordinate::minimize(f, x0);
+    BOOST_CHECK(res.status);
+    const auto g = minimize::grad::gradient(f, res.x, 1.e-6);
+    for(const auto gi : g) BOOST_CHECK_SMALL(gi, 1.e-5);
+}
+
+BOOST_AUTO_TEST_CASE(DeltaMatchesFull)
+{
+    const std::size_t n = 60;
+    const std::vector<double> x0(n, 0.);
+    const chain f;
+    const chain_delta fd;
+    const auto rf = minimize::coordinate::minimize(f, x0);
+    const auto rd = minimize::coordinate::minimize(fd, x0);
+    std::cout << "Full work: " << f.work << " Delta work: " << fd.work << std::endl;
+    BOOST_CHECK(rf.status);
+    BOOST_CHECK(rd.status);
+    BOOST_CHECK_CLOSE(rd.value, rf.value, 1.e-6);
+    for(std::size_t i = 0; i < n; i++) BOOST_CHECK_SMALL(rd.x[i] - rf.x[i], 1.e-5);
+    BOOST_CHECK_LT(10 * fd.work, f.work);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
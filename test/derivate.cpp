@@ -116,4 +116,29 @@ BOOST_AUTO_TEST_CASE(DerivateByDirection2D)
     BOOST_CHECK_CLOSE(res0, res1, 1.e-4);
 }
 
+BOOST_AUTO_TEST_CASE(DerivateByAxis3ND)
+{
+    const functor_nd func;
+    std::vector<double> x0{1., 2.};
+    auto    xr0 = minimize::ranges::const_range(x0);
+    auto    der0 = minimize::derivate::derive_by_axis_3(func, xr0, 0, 1.e-6),
+            der1 = minimize::derivate::derive_by_axis_3(func, xr0, 1, 1.e-6);
+    BOOST_CHECK_CLOSE(der0, 2., 1.e-4);
+    BOOST_CHECK_CLOSE(der1, 28., 1.e-4);
+}
+
+BOOST_AUTO_TEST_CASE(GradHessian2D)
+{
+    const functor_nd func;
+    std::vector<double> x0{3., 2.};
+    const auto xr0 = minimize::ranges::const_range(x0);
+    const auto gh = minimize::derivate::auto_grad_hessian(func, xr0);
+    BOOST_CHECK_CLOSE(gh.first.at(0), 6., 1.e-4);
+    BOOST_CHECK_CLOSE(gh.first.at(1), 28., 1.e-4);
+    BOOST_CHECK_CLOSE(gh.second.at(0), 2., 1.e-2);
+    BOOST_CHECK_CLOSE(gh.second.at(3), 46., 1.e-2);
+    BOOST_CHECK_LE(std::abs(gh.second.at(1)), 1.e-3);
+    BOOST_CHECK_EQUAL(gh.second.at(1), gh.second.at(2));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,57 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE DifferentialEvolution
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <atomic>
+#include <vector>
+
+#include <differential_evolution.hpp>
+
+BOOST_AUTO_TEST_SUITE(DifferentialEvolutionTests)
+
+struct rastrigin{
+    mutable std::atomic<std::size_t> calls{0};
+    template<typename Range>
+    double operator()(const Range& r) const{
+        calls++;
+        double ret_val = 10. * static_cast<double>(r.size());
+        for(std::size_t i = 0; i < r.size(); i++){
+            const double x = r.at(i);
+            ret_val += x * x - 10. * std::cos(2. * M_PI * x);
+        };
+        return ret_val;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(Rastrigin)
+{
+    const rastrigin f;
+    const minimize::box::bounds b{std::vector<double>(3, -5.12), std::vector<double>(3, 5.12)};
+    minimize::differential_evolution::params p;
+    p.seed = 3;
+    const auto res = minimize::differential_evolution::minimize(f, b, p, 2);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_LE(res.value, 1.e-6);
+    for(const auto x : res.x)
+        BOOST_CHECK_LE(std::abs(x), 1.e-3);
+}
+
+BOOST_AUTO_TEST_CASE(ReusedPopulation)
+{
+    const rastrigin f;
+    const std::size_t n = 2;
+    const minimize::box::bounds b{std::vector<double>(n, -2.), std::vector<double>(n, 2.)};
+    minimize::differential_evolution::population pop(20, n);
+    const double* points = pop.points.data();
+    const double* trials = pop.trials.data();
+    const minimize::evaluate::serial_evaluator<rastrigin> eval(f);
+    const auto r1 = minimize::differential_evolution::minimize_batched(eval, b, pop);
+    const auto r2 = minimize::differential_evolution::minimize_batched(eval, b, pop);
+    BOOST_CHECK_EQUAL(points, pop.points.data());
+    BOOST_CHECK_EQUAL(trials, pop.trials.data());
+    BOOST_CHECK_EQUAL(r1.value, r2.value);
+    BOOST_CHECK_EQUAL(f.calls.load(), 2 * pop.size * (r1.steps + 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
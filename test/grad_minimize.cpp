@@ -0,0 +1,145 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE GradMinimize
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+#include <grad_minimize.hpp>
+
+BOOST_AUTO_TEST_SUITE(GradMinimizeTests)
+
+struct counted_quadratic{
+    mutable std::size_t calls = 0;
+    template<typename Range>
+    double operator()(const Range& r) const{
+        calls++;
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++){
+            const double t = r.at(i) - static_cast<double>(i);
+            ret_val += static_cast<double>(i + 1) * t * t;
+        };
+        return ret_val;
+    };
+};
+
+struct rosenbrock{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        const double a = 1. - r.at(0), b = r.at(1) - r.at(0) * r.at(0);
+        return a * a + 100. * b * b;
+    };
+};
+
+// Coupled, badly scaled bowl whose minimum moves with shift
+struct drifting_bowl{
+    const double shift;
+    mutable std::size_t calls = 0;
+    template<typename Range>
+    double operator()(const Range& r) const{
+        calls++;
+        double ret_val = 0., prev = 0.;
+        for(std::size_t i = 0; i < r.size(); i++){
+            const double t = r.at(i) - shift * static_cast<double>(i + 1);
+            ret_val += std::pow(4., static_cast<double>(i)) * t * t + t * prev;
+            prev = t;
+        };
+        return ret_val;
+    };
+};
+
+// Rosenbrock with value and gradient in one pass; plain calls are counted
+struct rosenbrock_fdf{
+    mutable std::size_t calls = 0, fdf_calls = 0;
+    template<typename Range>
+    double operator()(const Range& r) const{
+        calls++;
+        return rosenbrock()(r);
+    };
+    double value_and_gradient(const std::vector<double>& x, std::vector<double>& g) const{
+        fdf_calls++;
+        const double a = 1. - x[0], b = x[1] - x[0] * x[0];
+        g[0] = - 2. * a - 400. * x[0] * b;
+        g[1] = 200. * b;
+        return a * a + 100. * b * b;
+    };
+};
+
+static_assert(minimize::derivate::has_value_and_gradient<rosenbrock_fdf>::value, "fdf detected");
+static_assert(!minimize::derivate::has_value_and_gradient<rosenbrock>::value, "plain functor");
+
+BOOST_AUTO_TEST_CASE(SteepestDescentQuadratic)
+{
+    const counted_quadratic f;
+    const std::vector<double> x0{5., 5., 5.};
+    const auto res = minimize::grad::steepest_descent(f, x0);
+    BOOST_CHECK(res.status);
+    for(std::size_t i = 0; i < x0.size(); i++)
+        BOOST_CHECK_LE(std::abs(res.x.at(i) - static_cast<double>(i)), 1.e-5);
+}
+
+BOOST_AUTO_TEST_CASE(BFGSRosenbrock)
+{
+    const rosenbrock f;
+    const std::vector<double> x0{-1.2, 1.};
+    const auto res = minimize::grad::bfgs_minimize(f, x0);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 1., 1.e-3);
+    BOOST_CHECK_CLOSE(res.x.at(1), 1., 1.e-3);
+    BOOST_CHECK_LE(res.value, 1.e-10);
+}
+
+BOOST_AUTO_TEST_CASE(WolfeCheaperThanGolden)
+{
+    const std::vector<double> x0{5., 5., 5., 5.};
+    const counted_quadratic fw, fg;
+    minimize::grad::params pg;
+    pg.line = minimize::grad::search::golden;
+    const auto rw = minimize::grad::bfgs_minimize(fw, x0);
+    const auto rg = minimize::grad::bfgs_minimize(fg, x0, pg);
+    std::cout << "Wolfe calls: " << fw.calls << " Golden calls: " << fg.calls << std::endl;
+    BOOST_CHECK(rw.status);
+    BOOST_CHECK(rg.status);
+    BOOST_CHECK_LT(fw.calls, fg.calls);
+}
+
+BOOST_AUTO_TEST_CASE(AnalyticGradient)
+{
+    const std::vector<double> x0{-1.2, 1.};
+    const rosenbrock_fdf f;
+    const auto res = minimize::grad::bfgs_minimize(f, x0);
+    std::cout << "Combined calls: " << f.fdf_calls << std::endl;
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 1., 1.e-4);
+    BOOST_CHECK_CLOSE(res.x.at(1), 1., 1.e-4);
+    BOOST_CHECK_EQUAL(f.calls, 0);
+    BOOST_CHECK_LT(f.fdf_calls, 3 * res.steps + 2);
+    const rosenbrock_fdf fs;
+    minimize::grad::params p;
+    p.tol = 1.e-4;
+    p.max_steps = 100000;
+    BOOST_CHECK(minimize::grad::steepest_descent(fs, x0, p).status);
+    BOOST_CHECK_EQUAL(fs.calls, 0);
+}
+
+BOOST_AUTO_TEST_CASE(WarmRestart)
+{
+    using namespace minimize;
+    const std::vector<double> x0(6, 1.);
+    const drifting_bowl f{0.};
+    grad::bfgs_state st = grad::bfgs_start(f, x0);
+    BOOST_CHECK(grad::bfgs_minimize(f, st).status);
+    const drifting_bowl cold{0.01}, warm{0.01};
+    const auto rc = grad::bfgs_minimize(cold, x0);
+    st = grad::bfgs_restart(warm, st);
+    const auto rw = grad::bfgs_minimize(warm, st);
+    std::cout << "Cold calls: " << cold.calls << " Warm calls: " << warm.calls << std::endl;
+    BOOST_CHECK(rc.status);
+    BOOST_CHECK(rw.status);
+    for(std::size_t i = 0; i < x0.size(); i++)
+        BOOST_CHECK_SMALL(rw.x.at(i) - rc.x.at(i), 1.e-6);
+    BOOST_CHECK_LT(2 * warm.calls, cold.calls);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
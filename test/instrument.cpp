@@ -0,0 +1,111 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Instrument
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <instrument.hpp>
+#include <minimize_1d.hpp>
+#include <grad_minimize.hpp>
+
+BOOST_AUTO_TEST_SUITE(InstrumentTests)
+
+using namespace minimize;
+
+struct parabola{
+    mutable std::size_t calls = 0;
+    double operator()(const double x) const{
+        calls++;
+        return (x - 0.3) * (x - 0.3);
+    };
+};
+
+struct rosenbrock{
+    mutable std::size_t calls = 0;
+    template<typename Range>
+    double operator()(const Range& r) const{
+        calls++;
+        const double x = r.at(0), y = r.at(1);
+        return 100. * (y - x * x) * (y - x * x) + (1. - x) * (1. - x);
+    };
+};
+
+struct rosenbrock_fdf : rosenbrock{
+    double value_and_gradient(const std::vector<double>& v, std::vector<double>& g) const{
+        calls++;
+        const double x = v[0], y = v[1], t = y - x * x;
+        g[0] = - 400. * x * t - 2. * (1. - x);
+        g[1] = 200. * t;
+        return 100. * t * t + (1. - x) * (1. - x);
+    };
+};
+
+BOOST_AUTO_TEST_CASE(GoldenCounts){
+    const parabola f, g;
+    std::vector<instrument::event> events;
+    auto rec = instrument::make_recorder([&events](const instrument::event& e){ events.push_back(e); });
+    const auto plain = D1::golden_ratio_minimize(f, {-2., 2.}, 1.e-8, 256);
+    const auto res = D1::golden_ratio_minimize(g, {-2., 2.}, 1.e-8, 256, rec);
+    BOOST_CHECK_EQUAL(plain.second, res.second);
+    BOOST_CHECK_EQUAL(rec.evaluations(), g.calls);
+    BOOST_CHECK_EQUAL(events.size() + 2, g.calls);
+    BOOST_CHECK_EQUAL(rec.calls(instrument::phase::line_search), 1);
+    for(std::size_t i = 1; i < events.size(); i++){
+        BOOST_CHECK_EQUAL(events[i].step, i + 1);
+        BOOST_CHECK_LT(events[i].progress, events[i - 1].progress);
+    };
+}
+
+BOOST_AUTO_TEST_CASE(WarmStartCounts){
+    const parabola f;
+    instrument::recorder<instrument::ignore_events> rec;
+    D1::golden_ratio_minimize(f, {-10., 10.}, 1.e-8, 256, D1::warm_start{0., 0.5}, rec);
+    BOOST_CHECK_EQUAL(rec.evaluations(), f.calls);
+}
+
+BOOST_AUTO_TEST_CASE(AutoGradCounts){
+    const rosenbrock f;
+    const std::vector<double> x{-1.2, 1.};
+    instrument::recorder<instrument::ignore_events> rec;
+    const auto plain = derivate::auto_grad(f, ranges::const_range(x));
+    const auto g = derivate::auto_grad(f, ranges::const_range(x), 1.e-8, rec);
+    BOOST_CHECK(plain == g);
+    BOOST_CHECK_EQUAL(rec.evaluations(), 8);
+    BOOST_CHECK_EQUAL(rec.calls(instrument::phase::gradient), 1);
+}
+
+BOOST_AUTO_TEST_CASE(BfgsPhases){
+    const rosenbrock f, g;
+    std::size_t events = 0;
+    auto rec = instrument::make_recorder([&events](const instrument::event& e){
+        events++;
+        BOOST_CHECK_EQUAL(e.step, events);
+    });
+    const std::vector<double> x0{-1.2, 1.};
+    const auto plain = grad::bfgs_minimize(f, x0);
+    const auto res = grad::bfgs_minimize(g, x0, {}, rec);
+    BOOST_CHECK(plain.x == res.x);
+    BOOST_CHECK_EQUAL(rec.evaluations(), g.calls);
+    BOOST_CHECK_EQUAL(events, res.steps);
+    BOOST_CHECK_EQUAL(rec.calls(instrument::phase::line_search), res.steps);
+    BOOST_CHECK_EQUAL(rec.calls(instrument::phase::gradient), res.steps + 1);
+    BOOST_CHECK_EQUAL(rec.calls(instrument::phase::linear_algebra), 2 * res.steps);
+    std::cout << "BFGS: " << rec.evaluations() << " evaluations, ns gradient / line search / linear algebra: "
+              << rec.ticks(instrument::phase::gradient) << " / "
+              << rec.ticks(instrument::phase::line_search) << " / "
+              << rec.ticks(instrument::phase::linear_algebra) << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(AnalyticCountsOnce){
+    const rosenbrock_fdf f;
+    instrument::recorder<instrument::ignore_events> rec;
+    const auto res = grad::steepest_descent(f, {-1.2, 1.}, {}, rec);
+    BOOST_CHECK_EQUAL(rec.evaluations(), f.calls);
+    BOOST_CHECK_GT(res.steps, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,108 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LeastSquares
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <atomic>
+#include <vector>
+#include <iostream>
+
+#include <least_squares.hpp>
+
+BOOST_AUTO_TEST_SUITE(LeastSquaresTests)
+
+struct exp_fit{
+    std::vector<double> ts, ys;
+    mutable std::atomic<std::size_t> calls{0};
+    exp_fit(const double a, const double b, const std::size_t m){
+        for(std::size_t i = 0; i < m; i++){
+            const double t = 0.1 * static_cast<double>(i);
+            ts.push_back(t);
+            ys.push_back(a * std::exp(b * t) + 0.01 * std::sin(7. * t));
+        };
+    };
+    template<typename Range, typename Out>
+    void operator()(const Range& x, Out out) const{
+        calls++;
+        const double a = x.at(0), b = x.at(1);
+        for(std::size_t i = 0; i < ts.size(); i++)
+            out[i] = a * std::exp(b * ts[i]) - ys[i];
+    };
+};
+
+struct rosenbrock_residuals{
+    template<typename Range, typename Out>
+    void operator()(const Range& x, Out out) const{
+        out[0] = 1. - x.at(0);
+        out[1] = 10. * (x.at(1) - x.at(0) * x.at(0));
+    };
+};
+
+struct wide_fit{
+    const std::size_t m = 30;
+    mutable std::atomic<std::size_t> calls{0};
+    template<typename Range, typename Out>
+    void operator()(const Range& x, Out out) const{
+        calls++;
+        for(std::size_t i = 0; i < m; i++){
+            const double t = static_cast<double>(i) / static_cast<double>(m);
+            double v = 0., tk = 1.;
+            for(std::size_t k = 0; k < x.size(); k++, tk *= t)
+                v += x.at(k) * tk + 0.1 * std::sin(x.at(k));
+            out[i] = v - std::cos(t);
+        };
+    };
+};
+
+BOOST_AUTO_TEST_CASE(ExponentialFit)
+{
+    const exp_fit f(2., -0.7, 40);
+    const std::vector<double> x0{1., 0.};
+    const auto res = minimize::least_squares::lm_minimize(f, f.ts.size(), x0);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 2., 1.);
+    BOOST_CHECK_CLOSE(res.x.at(1), -0.7, 1.);
+    BOOST_CHECK_LE(res.value, 1.e-2);
+}
+
+BOOST_AUTO_TEST_CASE(Rosenbrock)
+{
+    const rosenbrock_residuals f;
+    const std::vector<double> x0{-1.2, 1.};
+    minimize::least_squares::workspace ws(2, 2);
+    const auto res = minimize::least_squares::lm_minimize(f, 2, x0, ws);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 1., 1.e-4);
+    BOOST_CHECK_CLOSE(res.x.at(1), 1., 1.e-4);
+}
+
+BOOST_AUTO_TEST_CASE(BroydenAndParallelColumns)
+{
+    const wide_fit fb, ff, fp;
+    const std::vector<double> x0(6, 0.);
+    minimize::least_squares::params full, par;
+    full.refresh = 1;
+    par.threads = 2;
+    const auto rb = minimize::least_squares::lm_minimize(fb, fb.m, x0);
+    const auto rf = minimize::least_squares::lm_minimize(ff, ff.m, x0, full);
+    const auto rp = minimize::least_squares::lm_minimize(fp, fp.m, x0, par);
+    std::cout << "Broyden calls: " << fb.calls << " Full calls: " << ff.calls << std::endl;
+    BOOST_CHECK(rb.status);
+    BOOST_CHECK(rf.status);
+    BOOST_CHECK_CLOSE(rb.value, rf.value, 1.);
+    BOOST_CHECK_LE(fb.calls.load(), ff.calls.load());
+    BOOST_CHECK_EQUAL(rb.value, rp.value);
+}
+
+BOOST_AUTO_TEST_CASE(NoScheduledRefresh)
+{
+    const wide_fit f;
+    const std::vector<double> x0(6, 0.);
+    minimize::least_squares::params p;
+    p.refresh = 0;
+    const auto res = minimize::least_squares::lm_minimize(f, f.m, x0, p);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.value, minimize::least_squares::lm_minimize(f, f.m, x0).value, 1.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,50 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LineSearch
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <utility>
+
+#include <line_search.hpp>
+
+BOOST_AUTO_TEST_SUITE(LineSearchTests)
+
+struct phi_quartic{
+    mutable std::size_t calls = 0;
+    std::pair<double, double> operator()(const double a) const{
+        calls++;
+        const double t = a - 3.;
+        return {t * t * t * t - 2. * t * t, 4. * t * t * t - 4. * t};
+    };
+};
+
+BOOST_AUTO_TEST_CASE(CubicInterpolation)
+{
+    const minimize::line_search::point a{0., 0., -3.}, b{2., 2., 5.};
+    const auto x = minimize::line_search::cubic_min(a, b);
+    BOOST_CHECK_GT(x, 0.);
+    BOOST_CHECK_LT(x, 2.);
+}
+
+BOOST_AUTO_TEST_CASE(StrongWolfe)
+{
+    const phi_quartic phi;
+    const auto p0 = phi(0.);
+    phi.calls = 0;
+    const minimize::line_search::wolfe_params p;
+    const auto ls = minimize::line_search::wolfe_search(phi, p0.first, p0.second, 1., p);
+    BOOST_CHECK(ls.first);
+    BOOST_CHECK_LE(ls.second.value, p0.first + p.c1 * ls.second.alpha * p0.second);
+    BOOST_CHECK_LE(std::abs(ls.second.slope), - p.c2 * p0.second);
+    BOOST_CHECK_LE(phi.calls, 8);
+}
+
+BOOST_AUTO_TEST_CASE(AscentDirection)
+{
+    const phi_quartic phi;
+    const auto ls = minimize::line_search::wolfe_search(phi, 0., 1.);
+    BOOST_CHECK(!ls.first);
+    BOOST_CHECK_EQUAL(ls.second.alpha, 0.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,88 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Mapped
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <fstream>
+
+#include <unistd.h>
+
+#include <mapped.hpp>
+#include <derivate.hpp>
+#include <operations.hpp>
+
+BOOST_AUTO_TEST_SUITE(MappedTests)
+
+using namespace minimize;
+
+std::string temp_path(const std::string& name){
+    return "/tmp/minimize_" + name + "_" + std::to_string(getpid()) + ".bin";
+}
+
+struct quadratic{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++) ret_val += (r.at(i) - 1.) * (r.at(i) - 1.);
+        return ret_val;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(CreateAndReopen){
+    const std::string path = temp_path("create");
+    {
+        mapped::mapped_vector<double> x(path, 64);
+        BOOST_CHECK_EQUAL(x.size(), 64);
+        for(std::size_t i = 0; i < x.size(); i++) x[i] = static_cast<double>(i);
+        x.sync();
+    };
+    {
+        const mapped::mapped_vector<double> x(path, mapped::mode::read_only);
+        BOOST_CHECK_EQUAL(x.size(), 64);
+        BOOST_CHECK_EQUAL(x.at(63), 63.);
+        BOOST_CHECK_THROW(x.at(64), std::out_of_range);
+        const auto v = x.view();
+        BOOST_CHECK_EQUAL(ranges::data_of(v), x.data());
+        BOOST_CHECK_EQUAL(v.at(10), 10.);
+    };
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(InPlaceUpdate){
+    const std::string path = temp_path("update");
+    const std::size_t n = 1000;
+    {
+        mapped::mapped_vector<double> x(path, n);
+        std::fill(x.begin(), x.end(), 3.);
+        // Objective and gradient read the mapping directly
+        const auto g = derivate::auto_grad(quadratic(), x.view());
+        BOOST_CHECK_CLOSE(g.front(), 4., 1.e-2);
+        ranges::ops::assign(x, ranges::ops::axpy(x.view(), -0.25, g));
+        BOOST_CHECK_CLOSE(x[0], 2., 1.e-2);
+        mapped::mapped_vector<double> moved(std::move(x));
+        BOOST_CHECK_EQUAL(x.size(), 0);
+        BOOST_CHECK_EQUAL(moved.size(), n);
+    };
+    {
+        const mapped::mapped_vector<double> x(path);
+        BOOST_CHECK_CLOSE(x[n - 1], 2., 1.e-2);
+        BOOST_CHECK_CLOSE(quadratic()(x.view()), static_cast<double>(n), 1.e-2);
+    };
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(Errors){
+    const std::string path = temp_path("partial");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "abc";
+    };
+    BOOST_CHECK_THROW(mapped::mapped_vector<double>{path}, std::logic_error);
+    std::remove(path.c_str());
+    BOOST_CHECK_THROW(mapped::mapped_vector<double>{temp_path("missing")}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,8 @@
 
 #include <cmath>
 #include <vector>
+#include <utility>
+#include <type_traits>
 
 #include <minimize_1d.hpp>
 
@@ -44,4 +46,72 @@ BOOST_AUTO_TEST_CASE(AutoGoldenRation)
     BOOST_CHECK_CLOSE(f(mr), f.min_val(), 1.e-4);
 }
 
+BOOST_AUTO_TEST_CASE(BoundsSetScalar)
+{
+    const func_1d f{5.};
+    // Braced and integral bounds search in double whatever the tol type
+    const double braced = minimize::D1::auto_golden_ratio_minimize(f, {0., 3.});
+    BOOST_CHECK_CLOSE(braced, f.min_x(), 1.e-4);
+    const auto fr = minimize::D1::golden_ratio_minimize(f, std::pair<double, double>{0., 3.}, 1.e-6f, 1024);
+    BOOST_CHECK_CLOSE(fr.second, f.min_x(), 1.e-3);
+    const auto ir = minimize::D1::golden_ratio_minimize(f, std::pair{0, 3}, 1.e-6, 1024);
+    static_assert(std::is_same<decltype(ir.second), double>::value, "Integral bounds search in double");
+    BOOST_CHECK(ir.first);
+    BOOST_CHECK_CLOSE(ir.second, f.min_x(), 1.e-3);
+}
+
+struct counted_1d{
+    const double shift;
+    mutable std::size_t calls = 0;
+    double operator()(const double x) const{
+        calls++;
+        return std::cosh(x - shift);
+    };
+};
+
+BOOST_AUTO_TEST_CASE(WarmBracket)
+{
+    const std::pair bounds{-50., 50.};
+    const counted_1d cold{1.2004}, warm{1.2004}, moved{3.};
+    const auto rc = minimize::D1::golden_ratio_minimize(cold, bounds, 1.e-8, 1024);
+    const auto rw = minimize::D1::golden_ratio_minimize(warm, bounds, 1.e-8, 1024, {1.2, 1.e-3});
+    BOOST_CHECK(rc.first);
+    BOOST_CHECK(rw.first);
+    BOOST_CHECK_SMALL(rw.second - 1.2004, 1.e-6);
+    BOOST_CHECK_LT(3 * warm.calls, 2 * cold.calls);
+    const auto bracket = minimize::D1::warm_bracket(moved, bounds, {1.2, 1.e-3});
+    BOOST_CHECK_LT(bracket.a, 3.);
+    BOOST_CHECK_GT(bracket.b, 3.);
+    // A bracket that needs no growth costs three values and one interior point
+    const counted_1d still{1.2};
+    minimize::D1::warm_bracket(still, bounds, {1.2, 1.e-2});
+    BOOST_CHECK_EQUAL(still.calls, 4);
+}
+
+struct wavy{
+    double operator()(const double x) const{
+        return std::cos(3. * x) + 0.05 * x * x + 0.3 * x;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(WarmBracketNonUnimodal)
+{
+    // Cached values must belong to their points wherever the bracket
+    // wanders, and the best interior value must not exceed the ends
+    const wavy f;
+    const std::pair bounds{-100., 100.};
+    for(const double x0 : {-2., -1., -0.3, 0., 0.4, 1., 2.5}){
+        for(const double r : {0.05, 0.3, 1.}){
+            const auto s = minimize::D1::warm_bracket(f, bounds, {x0, r});
+            BOOST_CHECK_LT(s.a, s.c);
+            BOOST_CHECK_LT(s.c, s.d);
+            BOOST_CHECK_LT(s.d, s.b);
+            BOOST_CHECK_EQUAL(s.vc, f(s.c));
+            BOOST_CHECK_EQUAL(s.vd, f(s.d));
+            BOOST_CHECK_LE(std::min(s.vc, s.vd), f(s.a));
+            BOOST_CHECK_LE(std::min(s.vc, s.vd), f(s.b));
+        };
+    };
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
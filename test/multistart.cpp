@@ -0,0 +1,150 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Multistart
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <atomic>
+#include <random>
+#include <vector>
+#include <stdexcept>
+
+#include <multistart.hpp>
+
+BOOST_AUTO_TEST_SUITE(MultistartTests)
+
+struct six_hump_camel{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        const double x = r.at(0), y = r.at(1);
+        return (4. - 2.1 * x * x + x * x * x * x / 3.) * x * x + x * y + (-4. + 4. * y * y) * y * y;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(SobolStratification)
+{
+    const std::size_t count = 64, dim = minimize::sampling::sobol::max_dim;
+    const auto pts = minimize::sampling::sobol_points(count - 1, dim);
+    BOOST_CHECK_EQUAL(pts.at(0), 0.5);
+    for(std::size_t j = 0; j < dim; j++){
+        std::vector<std::size_t> bins(8, 0);
+        bins.at(0)++;
+        for(std::size_t i = 0; i + 1 < count; i++){
+            BOOST_CHECK_GE(pts.at(i * dim + j), 0.);
+            BOOST_CHECK_LT(pts.at(i * dim + j), 1.);
+            bins.at(static_cast<std::size_t>(8. * pts.at(i * dim + j)))++;
+        };
+        for(const auto b : bins) BOOST_CHECK_EQUAL(b, count / 8);
+    };
+    BOOST_CHECK_THROW(minimize::sampling::sobol(minimize::sampling::sobol::max_dim + 1), std::length_error);
+    BOOST_CHECK_THROW(minimize::sampling::sobol(0), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(LatinHypercube)
+{
+    const std::size_t count = 32, dim = 3;
+    std::mt19937_64 gen(7);
+    const auto pts = minimize::sampling::latin_hypercube(count, dim, gen);
+    for(std::size_t j = 0; j < dim; j++){
+        std::vector<std::size_t> bins(count, 0);
+        for(std::size_t i = 0; i < count; i++)
+            bins.at(static_cast<std::size_t>(count * pts.at(i * dim + j)))++;
+        for(const auto b : bins) BOOST_CHECK_EQUAL(b, 1);
+    };
+}
+
+BOOST_AUTO_TEST_CASE(WorkStealingNested)
+{
+    std::atomic<std::size_t> done{0};
+    minimize::parallel::work_stealing_pool pool(4);
+    for(std::size_t i = 0; i < 100; i++){
+        pool.push([&](const std::size_t w){
+            done++;
+            pool.push([&](const std::size_t){ done++; }, w);
+        });
+    };
+    pool.run();
+    BOOST_CHECK_EQUAL(done.load(), 200);
+}
+
+BOOST_AUTO_TEST_CASE(WorkStealingRethrows)
+{
+    std::atomic<std::size_t> done{0};
+    minimize::parallel::work_stealing_pool pool(4);
+    for(std::size_t i = 0; i < 100; i++){
+        pool.push([&done, i](const std::size_t){
+            if(i % 10 == 0) throw std::runtime_error("local search");
+            done++;
+        });
+    };
+    BOOST_CHECK_THROW(pool.run(), std::runtime_error);
+    BOOST_CHECK_EQUAL(done.load(), 90);
+    // The pool is reusable afterwards
+    pool.push([&done](const std::size_t){ done++; });
+    pool.run();
+    BOOST_CHECK_EQUAL(done.load(), 91);
+}
+
+BOOST_AUTO_TEST_CASE(SixHumpCamel)
+{
+    const six_hump_camel f;
+    const minimize::box::bounds b{{-3., -2.}, {3., 2.}};
+    minimize::multistart::params p;
+    p.threads = 4;
+    const auto res = minimize::multistart::minimize(f, b, p);
+    BOOST_CHECK_CLOSE(res.best.value, -1.0316284535, 1.e-4);
+    BOOST_CHECK_CLOSE(std::abs(res.best.x.at(0)), 0.0898420131, 1.e-2);
+    BOOST_CHECK_CLOSE(std::abs(res.best.x.at(1)), 0.7126564030, 1.e-2);
+    BOOST_CHECK_GE(res.minima.size(), 4);
+    BOOST_CHECK_GT(res.skipped, 0);
+    BOOST_CHECK_EQUAL(res.searches + res.skipped, p.count);
+    BOOST_CHECK_EQUAL(res.screened, p.count);
+}
+
+BOOST_AUTO_TEST_CASE(TargetStopsEarly)
+{
+    const six_hump_camel f;
+    const minimize::box::bounds b{{-3., -2.}, {3., 2.}};
+    minimize::multistart::params p;
+    p.method = minimize::multistart::starts::latin_hypercube;
+    p.target = 0.;
+    p.threads = 1;
+    const auto res = minimize::multistart::minimize(f, b, p);
+    BOOST_CHECK_LE(res.best.value, 0.);
+    BOOST_CHECK_LT(res.searches, p.count / 2);
+    BOOST_CHECK_LE(res.screened, res.searches + res.skipped);
+}
+
+BOOST_AUTO_TEST_CASE(TargetStopsRunningSearch)
+{
+    const six_hump_camel f;
+    minimize::multistart::params p;
+    p.check_every = 1;
+    const std::vector<double> x0{1.5, 1.};
+    const auto full = minimize::multistart::stoppable_bfgs(f, x0, p,
+        [](const double){ return false; });
+    const auto cut = minimize::multistart::stoppable_bfgs(f, x0, p,
+        [](const double v){ return v <= 0.; });
+    BOOST_CHECK(full.status);
+    BOOST_CHECK_LE(cut.value, 0.);
+    BOOST_CHECK_LT(cut.steps, full.steps);
+    // Slicing alone leaves the search unchanged
+    const auto plain = minimize::grad::bfgs_minimize(f, x0, p.local);
+    BOOST_CHECK_EQUAL(plain.steps, full.steps);
+    BOOST_CHECK_EQUAL(plain.value, full.value);
+    // Custom locals taking the predicate see it turn true after the target
+    minimize::multistart::params q;
+    q.threads = 1;
+    q.count = 16;
+    q.target = 0.;
+    std::size_t stopped = 0;
+    const auto local = [&](const six_hump_camel& fn, const std::vector<double>& x, const auto& stop){
+        const auto res = minimize::grad::bfgs_minimize(fn, x, q.local);
+        if(stop(res.value)) stopped++;
+        return res;
+    };
+    const minimize::box::bounds b{{-3., -2.}, {3., 2.}};
+    minimize::multistart::minimize_with(f, b, local, q);
+    BOOST_CHECK_GT(stopped, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,63 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE NelderMead
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <nelder_mead.hpp>
+
+BOOST_AUTO_TEST_SUITE(NelderMeadTests)
+
+struct rosenbrock{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        const double a = 1. - r.at(0), b = r.at(1) - r.at(0) * r.at(0);
+        return a * a + 100. * b * b;
+    };
+};
+
+struct abs_sum{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++)
+            ret_val += std::abs(r.at(i) - 0.5 * static_cast<double>(i));
+        return ret_val;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(Rosenbrock)
+{
+    const rosenbrock f;
+    const std::vector<double> x0{-1.2, 1.};
+    const auto res = minimize::nelder_mead::minimize(f, x0);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 1., 1.e-4);
+    BOOST_CHECK_CLOSE(res.x.at(1), 1., 1.e-4);
+}
+
+BOOST_AUTO_TEST_CASE(NonSmooth)
+{
+    const abs_sum f;
+    const std::vector<double> x0(3, 3.);
+    const auto res = minimize::nelder_mead::minimize(f, x0);
+    BOOST_CHECK(res.status);
+    for(std::size_t i = 0; i < x0.size(); i++)
+        BOOST_CHECK_LE(std::abs(res.x.at(i) - 0.5 * static_cast<double>(i)), 1.e-6);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelShrink)
+{
+    const abs_sum f;
+    const std::vector<double> x0(6, -2.);
+    minimize::nelder_mead::params p;
+    p.threads = 4;
+    const auto rs = minimize::nelder_mead::minimize(f, x0);
+    const auto rp = minimize::nelder_mead::minimize(f, x0, p);
+    BOOST_CHECK_EQUAL(rs.steps, rp.steps);
+    for(std::size_t i = 0; i < x0.size(); i++)
+        BOOST_CHECK_EQUAL(rs.x.at(i), rp.x.at(i));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define BOOST_TEST_MODULE Operations
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <numeric>
 #include <vector>
 
 #include <operations.hpp>
@@ -53,4 +55,80 @@ BOOST_AUTO_TEST_CASE(ScalarSum)
         BOOST_CHECK_EQUAL(mr.at(i), mul * data.at(i));
     };
 }
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+
+BOOST_AUTO_TEST_CASE(ClampRange)
+{
+    const std::vector<double> x{-3., 0.5, 7.}, lo{-1., -1., -1.}, hi{1., 1., 1.};
+    const auto cr = minimize::ranges::ops::clamp(x, lo, hi);
+    BOOST_CHECK_EQUAL(cr.size(), x.size());
+    BOOST_CHECK_EQUAL(cr.at(0), -1.);
+    BOOST_CHECK_EQUAL(cr.at(1), 0.5);
+    BOOST_CHECK_EQUAL(cr.at(2), 1.);
+}
+BOOST_AUTO_TEST_CASE(ZipAssignInPlace)
+{
+    using namespace minimize::ranges;
+    std::vector<double> m{1., 2., 3.};
+    const std::vector<double> g{1., 1., 1.}, v{4., 9., 16.};
+    const auto cm = const_range(m);
+    const auto blend = ops::sum(ops::scalar_mul(0.5, cm), ops::scalar_mul(0.5, const_range(g)));
+    BOOST_CHECK_EQUAL(blend.size(), 3);
+    ops::assign(m, blend);
+    BOOST_CHECK_EQUAL(m[2], 2.);
+    std::vector<double> out(3);
+    ops::assign(out, ops::zip([](const double a, const double b){ return a / std::sqrt(b); },
+        cm, const_range(v)));
+    BOOST_CHECK_EQUAL(out[0], 0.5);
+    BOOST_CHECK_EQUAL(out[2], 0.5);
+}
+BOOST_AUTO_TEST_CASE(AffineRange)
+{
+    using namespace minimize::ranges;
+    std::vector<double> x{1., 2., 3., 4.};
+    const std::vector<double> d{1., -1., 0.5, 2.}, e{2., 2., 2., 2.};
+    const auto ar = ops::axpy(x, 2., d);
+    BOOST_CHECK_EQUAL(ar.size(), x.size());
+    BOOST_CHECK_EQUAL(ar.at(1), 0.);
+    std::vector<double> it(ar.cbegin(), ar.cend());
+    for(std::size_t i = 0; i < x.size(); i++){
+        BOOST_CHECK_EQUAL(it[i], x[i] + 2. * d[i]);
+    };
+    const auto lazy = ops::sum(ar, const_range(e));
+    BOOST_CHECK_EQUAL(lazy.at(3), 4. + 4. + 2.);
+    const auto two = ops::affine(const_range(x), 1., d, -0.5, e);
+    BOOST_CHECK_EQUAL(two.at(2), 3. + 0.5 - 1.);
+    ops::assign(x, ar);
+    BOOST_CHECK_EQUAL(x[0], 3.);
+    BOOST_CHECK_EQUAL(x[3], 8.);
+    const std::vector<double> shorter(3);
+    BOOST_CHECK_THROW(ops::axpy(x, 1., shorter), std::length_error);
+    BOOST_CHECK_THROW(ops::affine(x, 1., d, 1., shorter), std::length_error);
+}
+BOOST_AUTO_TEST_CASE(CachedRange)
+{
+    using namespace minimize::ranges;
+    std::size_t calls = 0;
+    const auto counted_plus = [&calls](const double a, const double b){
+        calls++;
+        return a + b;
+    };
+    const std::vector<double> a{1., 2., 3.}, b{10., 20., 30.};
+    const auto lazy = ops::zip(counted_plus, const_range(a), const_range(b));
+    const auto cr = cached(lazy);
+    BOOST_CHECK_EQUAL(calls, 3);
+    for(int rep = 0; rep < 4; rep++){
+        BOOST_CHECK_EQUAL(cr.at(0), 11.);
+        BOOST_CHECK_EQUAL(cr.at(2), 33.);
+    };
+    BOOST_CHECK_EQUAL(calls, 3);
+    const auto copy = cr;
+    BOOST_CHECK_EQUAL(copy.at(1), 22.);
+    BOOST_CHECK(copy.data() != cr.data());
+    const std::vector<double> big(40, 1.), ones(40, 2.);
+    const auto cb = cached(ops::sum(const_range(big), const_range(ones)));
+    BOOST_CHECK_EQUAL(cb.size(), 40);
+    BOOST_CHECK_EQUAL(cb.at(39), 3.);
+    BOOST_CHECK_EQUAL(std::accumulate(cb.cbegin(), cb.cend(), 0.), 120.);
+    BOOST_CHECK_EQUAL(ops::axpy(cb, 0.5, big).at(0), 3.5);
+}
+BOOST_AUTO_TEST_SUITE_END()
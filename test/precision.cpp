@@ -0,0 +1,102 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Precision
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <type_traits>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <precision.hpp>
+#include <minimize_1d.hpp>
+#include <grad_minimize.hpp>
+
+BOOST_AUTO_TEST_SUITE(PrecisionTests)
+
+using namespace minimize;
+
+// Computes in the scalar type of its range
+struct weighted_squares{
+    template<typename Range>
+    auto operator()(const Range& r) const{
+        using T = typename Range::value_type;
+        T ret_val = 0;
+        for(std::size_t i = 0; i < r.size(); i++){
+            const T x = r.at(i) - T(1);
+            ret_val += T(i + 1) * x * x;
+        };
+        return ret_val;
+    };
+};
+
+// Accepts float points only
+struct float_rosenbrock{
+    mutable std::size_t calls = 0;
+    template<typename Range>
+    float operator()(const Range& r) const{
+        static_assert(std::is_same<typename Range::value_type, float>::value,
+            "Mixed adapter should hand float points to the objective");
+        calls++;
+        const float x = r.at(0), y = r.at(1);
+        return 100.f * (y - x * x) * (y - x * x) + (1.f - x) * (1.f - x);
+    };
+};
+
+BOOST_AUTO_TEST_CASE(FloatGradient){
+    const std::vector<float> x{0.5f, -0.25f, 2.f};
+    const auto g = derivate::auto_grad(weighted_squares(), ranges::const_range(x));
+    static_assert(std::is_same<decltype(g), const std::vector<double> >::value,
+        "Float stencils should be summed in double");
+    for(std::size_t i = 0; i < x.size(); i++)
+        BOOST_CHECK_CLOSE(g[i], 2. * (i + 1) * (x[i] - 1.), 1.e-2);
+}
+
+BOOST_AUTO_TEST_CASE(LongDoubleGradient){
+    const std::vector<long double> x{0.5L, -0.25L, 2.L};
+    const auto g = derivate::auto_grad(weighted_squares(), ranges::const_range(x));
+    static_assert(std::is_same<decltype(g), const std::vector<long double> >::value,
+        "Long double stencils should keep their precision");
+    for(std::size_t i = 0; i < x.size(); i++)
+        BOOST_CHECK_SMALL(static_cast<double>(g[i] - 2.L * (i + 1) * (x[i] - 1.L)), 1.e-9);
+}
+
+BOOST_AUTO_TEST_CASE(GoldenScalars){
+    const auto ff = [](const float x){ return (x - 0.3f) * (x - 0.3f); };
+    const auto fres = D1::golden_ratio_minimize(ff, std::pair<float, float>{-2.f, 2.f}, 1.e-5f, 64);
+    static_assert(std::is_same<decltype(fres.second), float>::value, "Float search");
+    BOOST_CHECK(fres.first);
+    BOOST_CHECK_SMALL(fres.second - 0.3f, 1.e-4f);
+    const auto fl = [](const long double x){ return std::cosh(x - 0.3L); };
+    const std::pair<long double, long double> bounds{-2.L, 2.L};
+    const auto lres = D1::golden_ratio_minimize(fl, bounds, 1.e-12L, 128);
+    BOOST_CHECK(lres.first);
+    BOOST_CHECK_SMALL(static_cast<double>(lres.second - 0.3L), 1.e-8);
+}
+
+BOOST_AUTO_TEST_CASE(MixedBfgs){
+    const float_rosenbrock f;
+    const auto fm = precision::evaluate_in<float>(f);
+    const auto res = grad::bfgs_minimize(fm, {-1.2, 1.}, precision::params_for<float>());
+    std::cout << "Mixed BFGS: " << f.calls << " float evaluations, x = "
+              << res.x[0] << ", " << res.x[1] << std::endl;
+    BOOST_CHECK_SMALL(res.x[0] - 1., 1.e-2);
+    BOOST_CHECK_SMALL(res.x[1] - 1., 2.e-2);
+}
+
+BOOST_AUTO_TEST_CASE(MixedOwnsTemporaries){
+    // The adapter outlives the lambda expression it was built from
+    const auto fm = precision::evaluate_in<float>([](const auto& r){
+        static_assert(std::is_same<typename std::decay_t<decltype(r)>::value_type, float>::value, "Float point");
+        return (r.at(0) - 0.5f) * (r.at(0) - 0.5f);
+    });
+    const std::vector<double> x{1.5};
+    BOOST_CHECK_CLOSE(fm(ranges::const_range(x)), 1., 1.e-5);
+    const float_rosenbrock f;
+    const auto shared = precision::evaluate_in<float>(f);
+    shared(ranges::const_range(std::vector<double>{0., 0.}));
+    BOOST_CHECK_EQUAL(f.calls, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,68 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Problems
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+#include <ranges.hpp>
+#include <problems.hpp>
+#include <grad_minimize.hpp>
+#include <least_squares.hpp>
+
+BOOST_AUTO_TEST_SUITE(ProblemsTests)
+
+using namespace minimize;
+
+BOOST_AUTO_TEST_CASE(KnownOptima){
+    std::size_t visited = 0;
+    problems::suite([&visited](const auto& p){
+        const std::vector<double> s = p.solution(), x0 = p.start();
+        BOOST_CHECK_EQUAL(s.size(), p.dim());
+        BOOST_CHECK_EQUAL(x0.size(), p.dim());
+        BOOST_CHECK_EQUAL(p.bounds().dim(), p.dim());
+        BOOST_CHECK_SMALL(p(ranges::const_range(s)) - p.optimum(), 1.e-9);
+        BOOST_CHECK_GT(p(ranges::const_range(x0)), p.optimum());
+        for(std::size_t i = 0; i < p.dim(); i++){
+            BOOST_CHECK_GE(s[i], p.bounds().lower[i]);
+            BOOST_CHECK_LE(s[i], p.bounds().upper[i]);
+        };
+        visited++;
+    }, 64);
+    BOOST_CHECK_EQUAL(visited, 10);
+}
+
+BOOST_AUTO_TEST_CASE(SparseQuadraticSolution){
+    const problems::sparse_quadratic q(500);
+    const std::vector<double> s = q.solution();
+    const double d = 2. + q.shift;
+    for(std::size_t i = 0; i < s.size(); i++){
+        double ax = d * s[i];
+        if(i > 0) ax -= s[i - 1];
+        if(i + 1 < s.size()) ax -= s[i + 1];
+        BOOST_CHECK_SMALL(ax - 1., 1.e-9);
+    };
+}
+
+BOOST_AUTO_TEST_CASE(CountedBfgs){
+    const problems::rosenbrock r(2);
+    const problems::counted<problems::rosenbrock> f(r);
+    const auto res = grad::bfgs_minimize(f, r.start());
+    std::cout << "Rosenbrock: " << f.calls() << " evaluations" << std::endl;
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_SMALL(problems::solution_error(r, res.x), 1.e-4);
+    BOOST_CHECK_GT(f.calls(), res.steps);
+}
+
+BOOST_AUTO_TEST_CASE(CountedResiduals){
+    const problems::exponential_fit e;
+    const problems::counted<problems::exponential_fit> f(e);
+    const auto res = least_squares::lm_minimize(f, e.residual_count(), e.start());
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_SMALL(problems::solution_error(e, res.x), 1.e-6);
+    BOOST_CHECK_SMALL(res.value, 1.e-12);
+    BOOST_CHECK_GT(f.calls(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,120 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ProcessPool
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+
+#include <signal.h>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <evaluate.hpp>
+#include <process_pool.hpp>
+#include <differential_evolution.hpp>
+
+BOOST_AUTO_TEST_SUITE(ProcessPoolTests)
+
+// Legacy-style objective: scratch buffer and call counter are globals
+static std::vector<double> scratch;
+static std::size_t global_calls = 0;
+
+struct legacy_quadratic{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        global_calls++;
+        scratch.resize(r.size());
+        for(std::size_t i = 0; i < r.size(); i++) scratch[i] = r.at(i);
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < scratch.size(); i++){
+            const double d = scratch[i] - 1. / static_cast<double>(i + 1);
+            ret_val += d * d;
+        };
+        return ret_val;
+    };
+};
+
+struct failing_above{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        if(r.at(0) > 0.) throw std::runtime_error("legacy failure");
+        return r.at(0);
+    };
+};
+
+// Stands in for a crash that takes the worker down without posting
+struct crashing_above{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        if(r.at(0) > 0.) raise(SIGKILL);
+        return r.at(0);
+    };
+};
+
+BOOST_AUTO_TEST_CASE(BatchLargerThanRing)
+{
+    const legacy_quadratic f;
+    const minimize::evaluate::process_evaluator<legacy_quadratic> eval(f, 3, 3, 4);
+    const std::size_t m = 100;
+    std::vector<double> points(3 * m), values(m), expected(m);
+    for(std::size_t i = 0; i < points.size(); i++) points[i] = std::sin(static_cast<double>(i));
+    const minimize::evaluate::serial_evaluator<legacy_quadratic> serial(f);
+    serial(points, 3, expected);
+    global_calls = 0;
+    eval(points, 3, values);
+    for(std::size_t i = 0; i < m; i++) BOOST_CHECK_EQUAL(values[i], expected[i]);
+    BOOST_CHECK_EQUAL(global_calls, 0);
+    BOOST_CHECK_EQUAL(eval.workers(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Gradient)
+{
+    const legacy_quadratic f;
+    const minimize::evaluate::process_evaluator<legacy_quadratic> eval(f, 4, 2);
+    const std::vector<double> x{0.5, -0.5, 2., 0.};
+    const auto g = minimize::evaluate::auto_grad(eval, x, 1.e-4);
+    const auto e = minimize::derivate::auto_grad(f, minimize::ranges::const_range(x), 1.e-4);
+    for(std::size_t i = 0; i < x.size(); i++) BOOST_CHECK_EQUAL(g[i], e[i]);
+}
+
+BOOST_AUTO_TEST_CASE(Population)
+{
+    const legacy_quadratic f;
+    const minimize::evaluate::process_evaluator<legacy_quadratic> eval(f, 3, 4);
+    const minimize::box::bounds b{std::vector<double>(3, -2.), std::vector<double>(3, 2.)};
+    minimize::differential_evolution::population pop(30, 3);
+    minimize::differential_evolution::params p;
+    p.seed = 11;
+    const auto res = minimize::differential_evolution::minimize_batched(eval, b, pop, p);
+    BOOST_CHECK(res.status);
+    for(std::size_t i = 0; i < res.x.size(); i++)
+        BOOST_CHECK_SMALL(res.x[i] - 1. / static_cast<double>(i + 1), 1.e-4);
+}
+
+BOOST_AUTO_TEST_CASE(FailureReported)
+{
+    const failing_above f;
+    const minimize::evaluate::process_evaluator<failing_above> eval(f, 1, 2, 2);
+    const std::vector<double> points{-1., 1., -2., -3.};
+    std::vector<double> values(4);
+    BOOST_CHECK_THROW(eval(points, 1, values), std::runtime_error);
+    const std::vector<double> good{-1., -2.};
+    std::vector<double> good_values(2);
+    eval(good, 1, good_values);
+    BOOST_CHECK_EQUAL(good_values[1], -2.);
+}
+
+BOOST_AUTO_TEST_CASE(DeadWorkerReported)
+{
+    const crashing_above f;
+    const minimize::evaluate::process_evaluator<crashing_above> eval(f, 1, 2, 2);
+    const std::vector<double> points{-1., 1., -2., -3.};
+    std::vector<double> values(4);
+    BOOST_CHECK_THROW(eval(points, 1, values), std::runtime_error);
+    const std::vector<double> good{-1., -2.};
+    std::vector<double> good_values(2);
+    BOOST_CHECK_THROW(eval(good, 1, good_values), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -83,4 +83,26 @@ BOOST_AUTO_TEST_CASE(ScalarRange)
         BOOST_CHECK_EQUAL(sr.at(i), body);
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_CASE(PointerViews)
+{
+    const double raw[5] = {1., 2., 3., 4., 5.};
+    const auto sr = minimize::ranges::span_range(raw, 5);
+    BOOST_CHECK_EQUAL(sr.size(), 5);
+    BOOST_CHECK_EQUAL(&sr.at(2), raw + 2);
+    BOOST_CHECK_EQUAL(minimize::ranges::data_of(sr), raw);
+    const minimize::ranges::subs_range sub(sr, {1, 7.});
+    BOOST_CHECK_EQUAL(sub.at(1), 7.);
+    BOOST_CHECK_EQUAL(sub.at(4), 5.);
+    struct point{
+        double x, y, z;
+    };
+    const point pts[3] = {{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}};
+    const minimize::ranges::strided_range<double> ys(&pts[0].y, 3, sizeof(point) / sizeof(double));
+    BOOST_CHECK_EQUAL(ys.size(), 3);
+    BOOST_CHECK_EQUAL(ys.at(2), 8.);
+    const std::vector<double> all(ys.cbegin(), ys.cend());
+    BOOST_CHECK(all == std::vector<double>({2., 5., 8.}));
+    BOOST_CHECK_THROW(minimize::ranges::strided_range<double>(raw, 1, 0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
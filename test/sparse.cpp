@@ -0,0 +1,94 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Sparse
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <sparse.hpp>
+#include <derivate.hpp>
+
+BOOST_AUTO_TEST_SUITE(SparseTests)
+
+using namespace minimize::ranges;
+using vec = std::vector<double>;
+
+BOOST_AUTO_TEST_CASE(StorageAndAccess)
+{
+    sparse_vector<double> sv(8);
+    sv.push_back(1, 2.);
+    sv.push_back(5, -3.);
+    BOOST_CHECK_THROW(sv.push_back(5, 1.), std::logic_error);
+    BOOST_CHECK_THROW(sv.push_back(8, 1.), std::logic_error);
+    const auto sr = sv.range();
+    BOOST_CHECK_EQUAL(sr.size(), 8);
+    BOOST_CHECK_EQUAL(sr.nnz(), 2);
+    BOOST_CHECK_EQUAL(sr.at(1), 2.);
+    BOOST_CHECK_EQUAL(sr.at(4), 0.);
+    const vec dense(sr.cbegin(), sr.cend());
+    BOOST_CHECK(dense == vec({0., 2., 0., 0., 0., -3., 0., 0.}));
+    const auto back = sparse(const_range(dense));
+    BOOST_CHECK(back.index() == sv.index());
+    BOOST_CHECK(back.values() == sv.values());
+    BOOST_CHECK_THROW(sparse_vector<double>(4, {2, 1}, {1., 1.}), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(SparseOperations)
+{
+    const sparse_vector<double> a(6, {0, 2, 4}, {1., 2., 3.}), b(6, {2, 3}, {10., 20.});
+    const auto scaled = ops::scalar_mul(2., a.range());
+    BOOST_CHECK_EQUAL(scaled.nnz(), 3);
+    BOOST_CHECK_EQUAL(scaled.at(4), 6.);
+    const auto s = ops::sum(a.range(), b.range());
+    BOOST_CHECK(s.index() == std::vector<std::size_t>({0, 2, 3, 4}));
+    BOOST_CHECK(s.values() == vec({1., 12., 20., 3.}));
+    const auto d = ops::sub(a.range(), b.range());
+    BOOST_CHECK_EQUAL(d.range().at(3), -20.);
+    const auto m = ops::mul(a.range(), b.range());
+    BOOST_CHECK_EQUAL(m.nnz(), 1);
+    BOOST_CHECK_EQUAL(m.range().at(2), 20.);
+    const vec x{1., 1., 2., 2., 3., 3.};
+    const auto md = ops::mul(const_range(x), a.range());
+    BOOST_CHECK(md.values() == vec({1., 4., 9.}));
+    BOOST_CHECK_EQUAL(ops::dot(a.range(), const_range(x)), 1. + 4. + 9.);
+    BOOST_CHECK_EQUAL(ops::dot(const_range(x), b.range()), 20. + 40.);
+    BOOST_CHECK_EQUAL(ops::dot(a.range(), b.range()), 20.);
+    BOOST_CHECK_EQUAL(ops::total(scaled), 12.);
+    BOOST_CHECK_CLOSE(ops::norm(a.range()), std::sqrt(14.), 1.e-10);
+    // Mixed with dense operands the lazy ranges still apply
+    const auto lazy = ops::sum(const_range(x), a.range());
+    BOOST_CHECK_EQUAL(lazy.at(4), 6.);
+    const sparse_vector<double> shorter(5);
+    BOOST_CHECK_THROW(ops::sum(a.range(), shorter.range()), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(SparseUpdate)
+{
+    vec x(6, 1.);
+    const sparse_vector<double> g(6, {1, 4}, {2., -4.});
+    ops::scatter_add(x, ops::scalar_mul(-0.5, g.range()));
+    BOOST_CHECK(x == vec({1., 0., 1., 1., 3., 1.}));
+    ops::assign(x, g.range());
+    BOOST_CHECK(x == vec({0., 2., 0., 0., -4., 0.}));
+}
+
+struct separable{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++) ret_val += (i % 3 == 0) ? r.at(i) * r.at(i) : 0.;
+        return ret_val;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(SparseGradient)
+{
+    const vec x{1., 2., 3., 4., 5., 6.};
+    const auto g = minimize::derivate::sparse_grad(separable(), const_range(x), {0, 3});
+    BOOST_CHECK_EQUAL(g.nnz(), 2);
+    BOOST_CHECK_CLOSE(g.range().at(0), 2., 1.e-4);
+    BOOST_CHECK_CLOSE(g.range().at(3), 8., 1.e-4);
+    BOOST_CHECK_EQUAL(g.range().at(1), 0.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,158 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Stochastic
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <atomic>
+#include <random>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+
+#include <stochastic.hpp>
+
+BOOST_AUTO_TEST_SUITE(StochasticTests)
+
+// Noise-free linear regression, term k = 0.5 (a_k . x - b_k)^2
+struct regression{
+    const std::size_t n;
+    std::vector<double> a, b, truth;
+    mutable std::atomic<std::size_t> evaluated{0};
+    regression(const std::size_t terms, const std::size_t dim):
+        n(dim), a(terms * dim), b(terms), truth(dim)
+        {
+            std::mt19937_64 gen(42);
+            std::normal_distribution<double> normal(0., 1.);
+            for(std::size_t j = 0; j < n; j++) truth[j] = static_cast<double>(j) - 1.;
+            for(std::size_t k = 0; k < terms; k++){
+                b[k] = 0.;
+                for(std::size_t j = 0; j < n; j++){
+                    a[k * n + j] = normal(gen);
+                    b[k] += a[k * n + j] * truth[j];
+                };
+            };
+        };
+    std::size_t term_count(void) const{
+        return b.size();
+    };
+    template<typename Indices>
+    double eval_terms(const std::vector<double>& x, const Indices& idx, std::vector<double>& g) const{
+        evaluated += idx.size();
+        double ret_val = 0.;
+        for(auto it = idx.cbegin(); it != idx.cend(); ++it){
+            const double* ak = a.data() + *it * n;
+            double r = - b[*it];
+            for(std::size_t j = 0; j < n; j++) r += ak[j] * x[j];
+            ret_val += 0.5 * r * r;
+            for(std::size_t j = 0; j < n; j++) g[j] += r * ak[j];
+        };
+        return ret_val;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(SGD)
+{
+    const regression f(4000, 5);
+    minimize::stochastic::params p;
+    p.batch = 64;
+    p.rate = 0.01;
+    p.tol = 1.e-5;
+    p.threads = 2;
+    const auto res = minimize::stochastic::sgd(f, std::vector<double>(5, 0.), p);
+    BOOST_CHECK(res.status);
+    for(std::size_t j = 0; j < 5; j++) BOOST_CHECK_SMALL(res.x[j] - f.truth[j], 1.e-4);
+}
+
+BOOST_AUTO_TEST_CASE(Adam)
+{
+    const regression f(4000, 5);
+    minimize::stochastic::params p;
+    p.batch = 64;
+    p.rate = 0.05;
+    p.tol = 1.e-3;
+    p.max_epochs = 200;
+    p.threads = 3;
+    const auto res = minimize::stochastic::adam(f, std::vector<double>(5, 0.), p);
+    BOOST_CHECK(res.status);
+    for(std::size_t j = 0; j < 5; j++) BOOST_CHECK_SMALL(res.x[j] - f.truth[j], 1.e-2);
+}
+
+BOOST_AUTO_TEST_CASE(SVRGMatchesAcrossThreads)
+{
+    const regression f(4000, 5);
+    minimize::stochastic::params p;
+    p.batch = 32;
+    p.rate = 0.05;
+    p.tol = 1.e-8;
+    p.threads = 1;
+    const auto rs = minimize::stochastic::svrg(f, std::vector<double>(5, 0.), p);
+    p.threads = 4;
+    const auto rp = minimize::stochastic::svrg(f, std::vector<double>(5, 0.), p);
+    BOOST_CHECK(rs.status);
+    BOOST_CHECK(rp.status);
+    for(std::size_t j = 0; j < 5; j++){
+        BOOST_CHECK_SMALL(rs.x[j] - f.truth[j], 1.e-7);
+        BOOST_CHECK_SMALL(rp.x[j] - rs.x[j], 1.e-7);
+    };
+}
+
+BOOST_AUTO_TEST_CASE(TeamRunsEveryThread)
+{
+    minimize::parallel::team tm(4);
+    std::vector<std::size_t> hits(tm.size(), 0);
+    for(std::size_t r = 0; r < 100; r++)
+        tm.run([&hits](const std::size_t t){ hits[t]++; });
+    for(const auto h : hits) BOOST_CHECK_EQUAL(h, 100);
+}
+
+BOOST_AUTO_TEST_CASE(TeamWaitsBeforeRethrow)
+{
+    minimize::parallel::team tm(4);
+    std::atomic<std::size_t> finished(0);
+    // The caller's share throws at once while the others are still busy
+    const auto job = [&finished](const std::size_t t){
+        if(t == 0) throw std::runtime_error("first");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        finished++;
+    };
+    BOOST_CHECK_THROW(tm.run(job), std::runtime_error);
+    BOOST_CHECK_EQUAL(finished.load(), tm.size() - 1);
+    BOOST_CHECK_THROW(tm.run([](const std::size_t t){
+        if(t == 1) throw std::logic_error("worker");
+    }), std::logic_error);
+    std::vector<std::size_t> hits(tm.size(), 0);
+    tm.run([&hits](const std::size_t t){ hits[t]++; });
+    for(const auto h : hits) BOOST_CHECK_EQUAL(h, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForRethrows)
+{
+    std::vector<int> done(64, 0);
+    // A worker's chunk and the caller's chunk throw; the rest still runs
+    BOOST_CHECK_THROW(minimize::parallel::parallel_for(done.size(), 4, [&done](const std::size_t i){
+        if((i == 0) || (i == 40)) throw std::length_error("objective");
+        done[i] = 1;
+    }), std::length_error);
+    BOOST_CHECK_EQUAL(done[16], 1);
+    BOOST_CHECK_EQUAL(done[1], 0);
+    BOOST_CHECK_EQUAL(done[39], 1);
+    BOOST_CHECK_EQUAL(done[41], 0);
+    BOOST_CHECK_THROW(minimize::parallel::parallel_for(8, 1, [](const std::size_t){
+        throw std::length_error("serial");
+    }), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForDynamicRethrows)
+{
+    std::atomic<std::size_t> calls(0);
+    BOOST_CHECK_THROW(minimize::parallel::parallel_for_dynamic(100000, 4,
+        [&calls](const std::size_t i, const std::size_t){
+            calls++;
+            if(i == 100) throw std::length_error("instance");
+        }, 4), std::length_error);
+    // Blocks stop being handed out after the failure
+    BOOST_CHECK_LT(calls.load(), 100000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
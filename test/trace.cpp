@@ -0,0 +1,101 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Trace
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <sstream>
+#include <iostream>
+
+#include <unistd.h>
+
+#include <trace.hpp>
+#include <minimize_1d.hpp>
+#include <grad_minimize.hpp>
+
+BOOST_AUTO_TEST_SUITE(TraceTests)
+
+using namespace minimize;
+
+std::string temp_path(const std::string& name){
+    return "/tmp/minimize_" + name + "_" + std::to_string(getpid()) + ".trace";
+}
+
+struct rosenbrock{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        const double x = r.at(0), y = r.at(1);
+        return 100. * (y - x * x) * (y - x * x) + (1. - x) * (1. - x);
+    };
+};
+
+BOOST_AUTO_TEST_CASE(BfgsHistory){
+    const std::string path = temp_path("bfgs");
+    const rosenbrock f;
+    grad::min_result_nd res;
+    std::uint64_t evaluations = 0;
+    {
+        // Tiny buffers force many hand-offs to the writer thread
+        trace::writer w(path, 2, 3);
+        trace::policy tp(w);
+        res = grad::bfgs_minimize(f, {-1.2, 1.}, {}, tp);
+        evaluations = tp.evaluations();
+    };
+    const auto records = trace::read(path);
+    BOOST_REQUIRE_EQUAL(records.size(), res.steps);
+    for(std::size_t i = 0; i < records.size(); i++){
+        BOOST_CHECK_EQUAL(records[i].iteration, i + 1);
+        if(i > 0){
+            BOOST_CHECK_GT(records[i].evaluations, records[i - 1].evaluations);
+            BOOST_CHECK_LE(records[i].value, records[i - 1].value);
+            const double dx = records[i].x[0] - records[i - 1].x[0],
+                         dy = records[i].x[1] - records[i - 1].x[1];
+            BOOST_CHECK_CLOSE(records[i].step, std::sqrt(dx * dx + dy * dy), 1.e-9);
+        };
+    };
+    BOOST_CHECK(std::isnan(records.front().step));
+    BOOST_CHECK_EQUAL(records.back().evaluations, evaluations);
+    BOOST_CHECK_EQUAL(records.back().value, res.value);
+    BOOST_CHECK(records.back().x == res.x);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(GoldenCsv){
+    const std::string path = temp_path("golden");
+    std::size_t steps = 0;
+    {
+        trace::writer w(path, 1);
+        trace::policy tp(w);
+        const auto res = D1::golden_ratio_minimize([](const double x){ return std::cosh(x - 0.5); },
+            {-3., 3.}, 1.e-6, 256, tp);
+        BOOST_CHECK(res.first);
+        // Two evaluations place the first bracket, then one per step
+        steps = tp.evaluations() - 2;
+        w.flush();
+        BOOST_CHECK_EQUAL(trace::read(path).size(), steps);
+    };
+    std::ostringstream csv;
+    trace::to_csv(path, csv);
+    std::istringstream lines(csv.str());
+    std::string line;
+    std::getline(lines, line);
+    BOOST_CHECK_EQUAL(line, "iteration,evaluations,value,progress,step,x0");
+    std::size_t count = 0;
+    while(std::getline(lines, line)) count++;
+    BOOST_CHECK_EQUAL(count, steps);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(RejectsForeignFile){
+    const std::string path = temp_path("foreign");
+    {
+        std::ofstream out(path);
+        out << "iteration,value\n";
+    };
+    BOOST_CHECK_THROW(trace::read(path), std::logic_error);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
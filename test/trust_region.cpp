@@ -0,0 +1,124 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TrustRegion
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <trust_region.hpp>
+
+BOOST_AUTO_TEST_SUITE(TrustRegionTests)
+
+struct rosenbrock{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        const double a = 1. - r.at(0), b = r.at(1) - r.at(0) * r.at(0);
+        return a * a + 100. * b * b;
+    };
+};
+
+struct rosenbrock_hessian{
+    template<typename Range>
+    void operator()(const Range& r, std::vector<double>& out) const{
+        const double x = r.at(0), y = r.at(1);
+        out.at(0) = 2. - 400. * (y - 3. * x * x);
+        out.at(1) = out.at(2) = - 400. * x;
+        out.at(3) = 200.;
+    };
+};
+
+struct ill_conditioned{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        double ret_val = 0.;
+        for(std::size_t i = 0; i < r.size(); i++){
+            const double t = r.at(i) - 1.;
+            ret_val += std::pow(10., static_cast<double>(i)) * t * t + 0.1 * t * t * t * t;
+        };
+        return ret_val;
+    };
+};
+
+struct rosenbrock_fdf : rosenbrock{
+    double value_and_gradient(const std::vector<double>& x, std::vector<double>& g) const{
+        const double a = 1. - x[0], b = x[1] - x[0] * x[0];
+        g[0] = - 2. * a - 400. * x[0] * b;
+        g[1] = 200. * b;
+        return a * a + 100. * b * b;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(FiniteDifferenceHessian)
+{
+    const rosenbrock f;
+    const std::vector<double> x0{-1.2, 1.};
+    const auto res = minimize::trust_region::newton_minimize(f, x0);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 1., 1.e-3);
+    BOOST_CHECK_CLOSE(res.x.at(1), 1., 1.e-3);
+    BOOST_CHECK_LE(res.steps, 64);
+}
+
+BOOST_AUTO_TEST_CASE(ExactHessian)
+{
+    const rosenbrock f;
+    const rosenbrock_hessian h;
+    const std::vector<double> x0{-1.2, 1.};
+    const auto res = minimize::trust_region::newton_minimize_hessian(f, h, x0);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 1., 1.e-3);
+    BOOST_CHECK_CLOSE(res.x.at(1), 1., 1.e-3);
+    BOOST_CHECK_LE(res.steps, 64);
+}
+
+BOOST_AUTO_TEST_CASE(IllConditioned)
+{
+    const ill_conditioned f;
+    const std::vector<double> x0(6, 3.);
+    const auto res = minimize::trust_region::newton_minimize(f, x0);
+    BOOST_CHECK(res.status);
+    for(std::size_t i = 0; i < x0.size(); i++)
+        BOOST_CHECK_CLOSE(res.x.at(i), 1., 1.e-3);
+    BOOST_CHECK_LE(res.steps, 32);
+}
+
+BOOST_AUTO_TEST_CASE(AnalyticGradient)
+{
+    const rosenbrock_fdf f;
+    const auto res = minimize::trust_region::newton_minimize(f, {-1.2, 1.});
+    BOOST_CHECK(res.status);
+    BOOST_CHECK_CLOSE(res.x.at(0), 1., 1.e-4);
+    BOOST_CHECK_CLOSE(res.x.at(1), 1., 1.e-4);
+}
+
+struct counted_rosenbrock : rosenbrock{
+    std::size_t* calls;
+    template<typename Range>
+    double operator()(const Range& r) const{
+        (*calls)++;
+        return rosenbrock::operator()(r);
+    };
+};
+
+BOOST_AUTO_TEST_CASE(ReusesAcceptedValue)
+{
+    std::size_t calls = 0, derivs_calls = 0;
+    const counted_rosenbrock f{{}, &calls};
+    const std::vector<double> x0{-1.2, 1.};
+    const minimize::trust_region::params p;
+    // Same iterates when the derivatives recompute f(x) themselves
+    const auto recompute = [&](const std::vector<double>& x){
+        derivs_calls++;
+        return minimize::derivate::auto_grad_hessian(f, minimize::ranges::const_range(x), p.h);
+    };
+    const auto slow = minimize::trust_region::newton_minimize(f, recompute, x0, p);
+    const std::size_t slow_calls = calls;
+    calls = 0;
+    const auto res = minimize::trust_region::newton_minimize(f, x0, p);
+    BOOST_CHECK(res.status);
+    BOOST_CHECK(res.x == slow.x);
+    BOOST_CHECK_EQUAL(res.steps, slow.steps);
+    BOOST_CHECK_EQUAL(calls + derivs_calls, slow_calls);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,138 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Workspace
+#include <boost/test/unit_test.hpp>
+
+#include <new>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include <ranges.hpp>
+#include <derivate.hpp>
+#include <evaluate.hpp>
+#include <grad_minimize.hpp>
+
+// Every heap allocation of the test binary passes through here
+std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t size){
+    allocations++;
+    if(void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept{
+    std::free(p);
+}
+
+BOOST_AUTO_TEST_SUITE(WorkspaceTests)
+
+using namespace minimize;
+
+struct rosenbrock{
+    template<typename Range>
+    double operator()(const Range& r) const{
+        double ret_val = 0.;
+        for(std::size_t i = 0; i + 1 < r.size(); i++){
+            const double a = r.at(i + 1) - r.at(i) * r.at(i), b = 1. - r.at(i);
+            ret_val += 100. * a * a + b * b;
+        };
+        return ret_val;
+    };
+};
+
+struct rosenbrock_fdf : rosenbrock{
+    double value_and_gradient(const std::vector<double>& x, std::vector<double>& g) const{
+        const std::size_t n = x.size();
+        std::fill(g.begin(), g.end(), 0.);
+        double ret_val = 0.;
+        for(std::size_t i = 0; i + 1 < n; i++){
+            const double a = x[i + 1] - x[i] * x[i], b = 1. - x[i];
+            ret_val += 100. * a * a + b * b;
+            g[i] += - 400. * a * x[i] - 2. * b;
+            g[i + 1] += 200. * a;
+        };
+        return ret_val;
+    };
+};
+
+BOOST_AUTO_TEST_CASE(GradientIntoBuffer){
+    const rosenbrock f;
+    const std::vector<double> x{-1.2, 1., 0.5, 0.2};
+    std::vector<double> out(x.size());
+    const std::size_t before = allocations.load();
+    derivate::auto_grad(f, ranges::const_range(x), out.data());
+    BOOST_CHECK_EQUAL(allocations.load(), before);
+    const auto fresh = derivate::auto_grad(f, ranges::const_range(x));
+    BOOST_CHECK(fresh == out);
+}
+
+BOOST_AUTO_TEST_CASE(BatchGradientWorkspace){
+    const rosenbrock f;
+    const evaluate::serial_evaluator<rosenbrock> eval(f);
+    const std::vector<double> x{-1.2, 1., 0.5};
+    std::vector<double> out(x.size());
+    evaluate::gradient_workspace ws(x.size());
+    const std::size_t before = allocations.load();
+    for(int k = 0; k < 8; k++) evaluate::auto_grad(eval, x, out, ws);
+    BOOST_CHECK_EQUAL(allocations.load(), before);
+    BOOST_CHECK(evaluate::auto_grad(eval, x) == out);
+}
+
+// Allocation counts seen by the observer after each step stay constant
+template<typename Func>
+void check_steady_bfgs(const Func& f, const grad::params& p){
+    const std::vector<double> x0{-1.2, 1., -1.2, 1., -1.2, 1.};
+    grad::bfgs_state st = grad::bfgs_start(f, x0, p);
+    grad::workspace ws(x0.size());
+    std::vector<std::size_t> seen;
+    seen.reserve(p.max_steps + 1);
+    const auto res = grad::bfgs_run(f, st, ws, p, [&seen](const grad::bfgs_state&){
+        seen.push_back(allocations.load());
+    });
+    BOOST_CHECK(res.status);
+    BOOST_REQUIRE_GT(seen.size(), 2);
+    BOOST_CHECK_EQUAL(seen.front(), seen.back());
+    const grad::min_result_nd plain = grad::bfgs_minimize(f, x0, p);
+    BOOST_CHECK(plain.x == res.x);
+}
+
+BOOST_AUTO_TEST_CASE(SteadyStateWolfe){
+    check_steady_bfgs(rosenbrock(), grad::params());
+}
+
+BOOST_AUTO_TEST_CASE(SteadyStateGolden){
+    grad::params p;
+    p.line = grad::search::golden;
+    p.max_steps = 4096;
+    check_steady_bfgs(rosenbrock(), p);
+}
+
+BOOST_AUTO_TEST_CASE(SteadyStateAnalytic){
+    check_steady_bfgs(rosenbrock_fdf(), grad::params());
+}
+
+BOOST_AUTO_TEST_CASE(SteadyStateSteepest){
+    const rosenbrock f;
+    const std::vector<double> x0{-1.2, 1.};
+    grad::params p;
+    p.max_steps = 64;
+    grad::workspace ws(x0.size());
+    std::vector<std::size_t> seen;
+    seen.reserve(p.max_steps + 1);
+    auto rec = instrument::make_recorder([&seen](const instrument::event&){
+        seen.push_back(allocations.load());
+    });
+    const auto res = grad::steepest_descent(f, x0, ws, p, rec);
+    BOOST_REQUIRE_GT(seen.size(), 2);
+    BOOST_CHECK_EQUAL(seen.front(), seen.back());
+    BOOST_CHECK(grad::steepest_descent(f, x0, p).x == res.x);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file